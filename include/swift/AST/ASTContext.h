@@ -47,6 +47,12 @@ namespace clang {
   class ObjCInterfaceDecl;
 }
 
+namespace llvm {
+namespace markup {
+  class MarkupContext;
+}
+}
+
 namespace swift {
   class ASTContext;
   class BoundGenericType;
@@ -818,6 +824,12 @@ private:
   Optional<StringRef> getBriefComment(const Decl *D);
   void setBriefComment(const Decl *D, StringRef Comment);
 
+  /// Returns None if \p D's doc comment has not been parsed yet, or null if
+  /// it has no doc comment.
+  Optional<DocComment *> getDocComment(const Decl *D);
+  void setDocComment(const Decl *D, DocComment *Comment);
+  llvm::markup::MarkupContext &getMarkupContext();
+
   friend class BoundGenericType;
 
   /// \brief Set the substitutions for the given bound generic type.
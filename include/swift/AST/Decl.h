@@ -60,6 +60,7 @@ namespace swift {
   class ConstructorDecl;
   class DestructorDecl;
   class DiagnosticEngine;
+  class DocComment;
   class DynamicSelfType;
   class Type;
   class Expr;
@@ -827,6 +828,12 @@ public:
   /// \returns the brief comment attached to this declaration.
   StringRef getBriefComment() const;
 
+  /// \returns the parsed documentation comment attached to this declaration.
+  ///
+  /// The comment is parsed the first time it is requested and then shared by
+  /// all clients of the ASTContext.
+  Optional<DocComment *> getDocComment() const;
+
   /// \brief Returns true if there is a Clang AST node associated
   /// with self.
   bool hasClangNode() const {
@@ -224,6 +224,11 @@ private:
 
   SmallVector<FileUnit *, 2> Files;
 
+  /// Incremented whenever a file is added or removed, or top-level
+  /// declarations are added to a file, so that lookup results which depend on
+  /// the module's other files can be invalidated lazily.
+  unsigned TopLevelDeclGeneration = 0;
+
   /// Tracks the file that will generate the module's entry point, either
   /// because it contains a class marked with \@UIApplicationMain
   /// or \@NSApplicationMain, or because it is a script file.
@@ -294,6 +299,18 @@ public:
   void addFile(FileUnit &newFile);
   void removeFile(FileUnit &existingFile);
 
+  /// Returns a number which changes whenever the module's top-level
+  /// declarations may have changed.
+  unsigned getTopLevelDeclGeneration() const {
+    return TopLevelDeclGeneration;
+  }
+
+  /// Notes that top-level declarations have been added to one of the
+  /// module's files after it was added to the module.
+  void addedTopLevelDecls() {
+    ++TopLevelDeclGeneration;
+  }
+
   /// Convenience accessor for clients that know what kind of file they're
   /// dealing with.
   SourceFile &getMainSourceFile(SourceFileKind expectedKind) const;
@@ -792,6 +809,7 @@ public:
 
   void addDerivedDecl(FuncDecl *FD) {
     DerivedDecls.push_back(FD);
+    getParentModule()->addedTopLevelDecls();
   }
 
   void lookupValue(ModuleDecl::AccessPathTy accessPath, DeclName name,
@@ -945,6 +963,17 @@ public:
   void cacheVisibleDecls(SmallVectorImpl<ValueDecl *> &&globals) const;
   const SmallVectorImpl<ValueDecl *> &getCachedVisibleDecls() const;
 
+  /// Record the declarations found by an unqualified lookup of \p name which
+  /// reached the top level of this file. \p options distinguishes lookups
+  /// which can find different declarations, such as type-only lookups.
+  void cacheUnqualifiedLookup(DeclName name, unsigned options,
+                              ArrayRef<ValueDecl *> results) const;
+
+  /// Returns the declarations recorded by cacheUnqualifiedLookup, or null if
+  /// there are none.
+  const SmallVectorImpl<ValueDecl *> *
+  getCachedUnqualifiedLookup(DeclName name, unsigned options) const;
+
   virtual void lookupValue(ModuleDecl::AccessPathTy accessPath, DeclName name,
                            NLKind lookupKind,
                            SmallVectorImpl<ValueDecl*> &result) const override;
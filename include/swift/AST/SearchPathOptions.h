@@ -52,6 +52,10 @@ public:
 
   /// Don't look in for compiler-provided modules.
   bool SkipRuntimeLibraryImportPath = false;
+
+  /// A file through which compiler jobs share listings of the search paths,
+  /// or empty to list them in every job.
+  std::string SearchPathListingCachePath;
 };
 
 }
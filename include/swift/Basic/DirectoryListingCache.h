@@ -0,0 +1,108 @@
+//===--- DirectoryListingCache.h - Cached search path listings --*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A process-wide cache of the names in directories that are searched for
+// many different files, such as the import and framework search paths.
+//
+// Looking for M modules in N search paths costs N directory listings instead
+// of up to M * N failed opens.  The listings can be saved to a file and
+// loaded by other compiler jobs, which then only stat each directory to
+// check that its listing is still current.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_BASIC_DIRECTORYLISTINGCACHE_H
+#define SWIFT_BASIC_DIRECTORYLISTINGCACHE_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/TimeValue.h"
+#include <mutex>
+#include <system_error>
+
+namespace swift {
+
+/// Caches the entries of directories; see the file comment.
+class DirectoryListingCache {
+  struct Listing {
+    /// False if the directory did not exist when it was listed.
+    bool Exists = false;
+
+    /// The modification time of the directory when it was listed.
+    llvm::sys::TimeValue ModTime;
+
+    /// True if the directory was listed so soon after it was modified that
+    /// a further change might not have changed its modification time.
+    bool IsRacy = false;
+
+    /// The lowercased names of the entries in the directory.
+    llvm::StringSet<> Names;
+  };
+
+  llvm::StringMap<Listing> Listings;
+
+  /// True if a directory has been listed since the listings were last loaded
+  /// or saved.
+  bool HasNewListings = false;
+
+  std::mutex Mutex;
+
+  const Listing *getListing(StringRef dir, bool listIfNeeded);
+
+public:
+  /// Returns the cache shared by everything in this process.
+  static DirectoryListingCache &get();
+
+  /// Lists \p dir, unless it has been listed already.
+  void listDirectory(StringRef dir);
+
+  /// Returns false if \p dir is known not to contain an entry named \p name,
+  /// listing \p dir first if necessary.
+  ///
+  /// Returns true if the entry may exist, including when \p dir can't be
+  /// listed.  Names are compared case-insensitively, and names that aren't
+  /// ASCII always may exist, so that this never rules out a file that
+  /// opening it by name would find.
+  bool mayContain(StringRef dir, StringRef name);
+
+  /// Returns false if some ancestor directory of \p path has been listed and
+  /// does not contain the next component of \p path.
+  ///
+  /// Unlike \c mayContain, this never lists a directory.
+  bool mayExist(StringRef path);
+
+  /// Forgets the listings of directories that have been modified since they
+  /// were listed, or might have been.
+  ///
+  /// Processes that compile more than once should call this before each
+  /// compile, so that they notice files added to the search paths.
+  void removeStaleListings();
+
+  /// Adds the listings saved in \p file, except those of directories that
+  /// have been modified since they were listed.
+  std::error_code load(StringRef file);
+
+  /// Saves the listings to \p file, if any directory has been listed since
+  /// they were last loaded or saved.
+  ///
+  /// Listings of directories that were modified just before they were
+  /// listed are left out, since later changes might not be detectable.
+  ///
+  /// The file is replaced atomically, so that compiler jobs running in
+  /// parallel can share one file.
+  std::error_code save(StringRef file);
+};
+
+} // end namespace swift
+
+#endif
@@ -140,6 +140,15 @@ namespace swift {
     /// allocated by the constraint solver.
     unsigned SolverMemoryThreshold = 15000000;
 
+    /// \brief The number of sub-expressions that may be re-type-checked while
+    /// diagnosing one expression that failed to type-check, before giving up
+    /// and reporting the expression as too complex.
+    unsigned DiagnosisRecheckLimit = 1000;
+
+    /// \brief Repeat sub-expression re-type-checks that already failed while
+    /// diagnosing the same expression, instead of skipping them.
+    bool DisableDiagnosisMemoization = false;
+
     /// \brief Perform all dynamic allocations using malloc/free instead of
     /// optimized custom allocator, so that memory debugging tools can be used.
     bool UseMalloc = false;
@@ -0,0 +1,102 @@
+//===--- Tracing.h - Low-overhead timed spans -------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Records the start and end times of named spans of work, such as compiler
+// phases or SourceKit requests, so that they can be viewed on a timeline.
+//
+// Each thread records into its own fixed-size ring buffer without taking any
+// locks; once a buffer is full, the oldest spans on that thread are
+// overwritten.  The buffers of threads that have exited are reused by new
+// threads.  The recorded spans can be written out in the Chrome trace
+// event format, which chrome://tracing and other viewers can open.
+//
+// When tracing is disabled, a TracedSpan costs one relaxed atomic load.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_BASIC_TRACING_H
+#define SWIFT_BASIC_TRACING_H
+
+#include "swift/Basic/LLVM.h"
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+namespace swift {
+namespace tracing {
+
+/// The number of spans each thread keeps before overwriting its oldest.
+const uint64_t SpansPerThread = 1 << 14;
+
+namespace detail {
+extern std::atomic<bool> Enabled;
+} // end namespace detail
+
+/// Returns true if spans are being recorded.
+inline bool isEnabled() {
+  return detail::Enabled.load(std::memory_order_relaxed);
+}
+
+/// Starts recording spans, on all threads.
+void enable();
+
+/// Stops recording spans.  Spans recorded so far are kept.
+void disable();
+
+/// Returns the current time in nanoseconds, from a clock that only moves
+/// forwards.
+uint64_t now();
+
+/// Records a span on the current thread's buffer.
+///
+/// \p name and \p category must be string literals, or otherwise outlive all
+/// calls to writeChromeTrace().
+void recordSpan(const char *name, const char *category, uint64_t startTime,
+                uint64_t endTime);
+
+/// Writes all spans recorded so far as a Chrome trace event JSON object.
+///
+/// This may be called while other threads are recording spans; spans that
+/// are overwritten while they are being read are left out.
+void writeChromeTrace(raw_ostream &os);
+
+/// Writes all spans recorded so far to the file at \p path.
+std::error_code writeChromeTrace(StringRef path);
+
+/// Records a span from its construction to its destruction, if tracing was
+/// enabled when it was constructed.
+class TracedSpan {
+  const char *Name;
+  const char *Category;
+  uint64_t StartTime = 0;
+
+public:
+  /// \p name and \p category must be string literals; see recordSpan().
+  TracedSpan(const char *name, const char *category)
+      : Name(name), Category(category) {
+    if (isEnabled())
+      StartTime = now();
+  }
+
+  ~TracedSpan() {
+    if (StartTime)
+      recordSpan(Name, Category, StartTime, now());
+  }
+
+  TracedSpan(const TracedSpan &) = delete;
+  TracedSpan &operator=(const TracedSpan &) = delete;
+};
+
+} // end namespace tracing
+} // end namespace swift
+
+#endif
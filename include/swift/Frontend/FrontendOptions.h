@@ -125,6 +125,10 @@ public:
   /// The path to output swift interface files for the compiled source files.
   std::string DumpAPIPath;
 
+  /// The path to write the timeline of compiler phases to, in the Chrome
+  /// trace event format.
+  std::string TraceEventsPath;
+
   enum ActionType {
     NoneAction, ///< No specific action
     Parse, ///< Parse and type-check only
@@ -166,6 +170,10 @@ public:
   /// If set, dumps wall time taken to check each function body to llvm::errs().
   bool DebugTimeFunctionBodies = false;
 
+  /// If set, dumps the time taken to diagnose each expression that fails to
+  /// type-check to llvm::errs().
+  bool DebugTimeExpressionDiagnosis = false;
+
   /// Indicates whether function body parsing should be delayed
   /// until the end of all files.
   bool DelayedFunctionBodyParsing = false;
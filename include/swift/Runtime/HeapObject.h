@@ -500,6 +500,9 @@ extern "C" void swift_weakAssign(WeakReference *ref, HeapObject *value);
 /// non-null object that has begun deallocation, returns null;
 /// otherwise, retains the object before returning.
 ///
+/// This does not modify the reference, so it is safe to call from several
+/// threads at once on the same reference.
+///
 /// \param ref - never null
 /// \return can be null
 extern "C" HeapObject *swift_weakLoadStrong(WeakReference *ref);
@@ -22,6 +22,7 @@
 #include "swift/Sema/TypeCheckRequest.h"
 #include "swift/AST/DiagnosticEngine.h"
 #include "swift/Basic/LLVM.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/STLExtras.h"
 
@@ -43,6 +44,10 @@ class IterativeTypeChecker {
   /// A stack of the currently-active requests.
   SmallVector<TypeCheckRequest, 4> ActiveRequests;
 
+  /// The requests in \c ActiveRequests, used to detect circular
+  /// dependencies without scanning the stack.
+  llvm::DenseSet<TypeCheckRequest> ActiveRequestSet;
+
   // Declare the is<request kind>Satisfied predicates,
   // enumerateDependenciesOf<request kind> functions, and
   // satisfy<request kind> functions.
@@ -93,6 +98,10 @@ public:
   /// type of a declaration, perform name lookup into a particular
   /// context, and so on.
   void satisfy(TypeCheckRequest request);
+
+  /// Retrieve the dependencies that were found to be unsatisfied while
+  /// processing the given request, in the order in which they were found.
+  ArrayRef<TypeCheckRequest> getDependencies(TypeCheckRequest request) const;
 };
 
 }
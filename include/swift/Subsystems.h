@@ -151,7 +151,11 @@ namespace swift {
 
     /// Indicates that the type checker is checking code that will be
     /// immediately executed.
-    ForImmediateMode = 1 << 2
+    ForImmediateMode = 1 << 2,
+
+    /// If set, dumps the time taken to diagnose each expression that fails to
+    /// type-check to llvm::errs().
+    DebugTimeExpressionDiagnosis = 1 << 3
   };
 
   /// Once parsing and name-binding are complete, this walks the AST to resolve
@@ -18,6 +18,7 @@
 #include "swift/Strings.h"
 #include "swift/AST/ArchetypeBuilder.h"
 #include "swift/AST/AST.h"
+#include "swift/AST/Comment.h"
 #include "swift/AST/ConcreteDeclRef.h"
 #include "swift/AST/DiagnosticEngine.h"
 #include "swift/AST/DiagnosticsSema.h"
@@ -197,6 +198,13 @@ struct ASTContext::Implementation {
   /// \brief Map from Swift declarations to brief comments.
   llvm::DenseMap<const Decl *, StringRef> BriefComments;
 
+  /// \brief Map from Swift declarations to parsed doc comments, or null for
+  /// declarations without one.
+  llvm::DenseMap<const Decl *, DocComment *> DocComments;
+
+  /// \brief The context which owns the parsed doc comments.
+  llvm::markup::MarkupContext MarkupCtx;
+
   /// \brief Map from local declarations to their discriminators.
   /// Missing entries implicitly have value 0.
   llvm::DenseMap<const ValueDecl *, unsigned> LocalDiscriminators;
@@ -1440,6 +1448,22 @@ void ASTContext::setBriefComment(const Decl *D, StringRef Comment) {
   Impl.BriefComments[D] = Comment;
 }
 
+Optional<DocComment *> ASTContext::getDocComment(const Decl *D) {
+  auto Known = Impl.DocComments.find(D);
+  if (Known == Impl.DocComments.end())
+    return None;
+
+  return Known->second;
+}
+
+void ASTContext::setDocComment(const Decl *D, DocComment *Comment) {
+  Impl.DocComments[D] = Comment;
+}
+
+llvm::markup::MarkupContext &ASTContext::getMarkupContext() {
+  return Impl.MarkupCtx;
+}
+
 unsigned ValueDecl::getLocalDiscriminator() const {
   assert(getDeclContext()->isLocalContext());
   auto &discriminators = getASTContext().Impl.LocalDiscriminators;
@@ -1605,6 +1629,7 @@ size_t ASTContext::getTotalMemory() const {
     llvm::capacity_in_bytes(Impl.ModuleLoaders) +
     llvm::capacity_in_bytes(Impl.RawComments) +
     llvm::capacity_in_bytes(Impl.BriefComments) +
+    llvm::capacity_in_bytes(Impl.DocComments) +
     llvm::capacity_in_bytes(Impl.LocalDiscriminators) +
     llvm::capacity_in_bytes(Impl.ModuleTypes) +
     llvm::capacity_in_bytes(Impl.GenericParamTypes) +
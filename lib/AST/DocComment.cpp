@@ -17,6 +17,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/AST/Comment.h"
+#include "swift/AST/ASTContext.h"
 #include "swift/AST/Decl.h"
 #include "swift/AST/PrettyStackTrace.h"
 #include "swift/AST/RawComment.h"
@@ -333,3 +334,16 @@ Optional<DocComment *> swift::getDocComment(llvm::markup::MarkupContext &MC,
   auto Parts = extractCommentParts(MC, Doc);
   return new (MC) DocComment(D, Doc, Parts);
 }
+
+Optional<DocComment *> Decl::getDocComment() const {
+  auto &Context = getASTContext();
+  if (Optional<DocComment *> Cached = Context.getDocComment(this)) {
+    if (!Cached.getValue())
+      return None;
+    return Cached;
+  }
+
+  auto DC = swift::getDocComment(Context.getMarkupContext(), this);
+  Context.setDocComment(this, DC.hasValue() ? DC.getValue() : nullptr);
+  return DC;
+}
@@ -159,9 +159,30 @@ public:
                          const SourceFile &SF);
 
   SmallVector<ValueDecl *, 0> AllVisibleValues;
+
+  /// The module's top-level declaration generation when UnqualifiedResults
+  /// was last cleared.
+  unsigned ModuleDeclsGeneration = 0;
+
+  /// Clears the cached lookups that can find declarations in other files if
+  /// the module's top-level declarations have changed since they were cached.
+  void checkModuleDecls(const SourceFile &SF);
+
+  /// The results of unqualified lookups which reached the top level of this
+  /// file, keyed by name and lookup options.
+  llvm::DenseMap<std::pair<DeclName, unsigned>, SmallVector<ValueDecl *, 4>>
+    UnqualifiedResults;
 };
 using SourceLookupCache = SourceFile::LookupCache;
 
+void SourceLookupCache::checkModuleDecls(const SourceFile &SF) {
+  unsigned generation = SF.getParentModule()->getTopLevelDeclGeneration();
+  if (generation == ModuleDeclsGeneration)
+    return;
+  ModuleDeclsGeneration = generation;
+  UnqualifiedResults.clear();
+}
+
 SourceLookupCache &SourceFile::getCache() const {
   if (!Cache) {
     const_cast<SourceFile *>(this)->Cache =
@@ -326,6 +347,7 @@ void SourceLookupCache::invalidate() {
   TopLevelValues.clear();
   ClassMembers.clear();
   MemberCachePopulated = false;
+  UnqualifiedResults.shrink_and_clear();
 
   // std::move AllVisibleValues into a temporary to destroy its contents.
   using SameSizeSmallVector = decltype(AllVisibleValues);
@@ -355,6 +377,7 @@ void Module::addFile(FileUnit &newFile) {
          cast<SourceFile>(newFile).Kind == SourceFileKind::Library ||
          cast<SourceFile>(newFile).Kind == SourceFileKind::SIL);
   Files.push_back(&newFile);
+  ++TopLevelDeclGeneration;
 
   switch (newFile.getKind()) {
   case FileUnitKind::Source:
@@ -387,6 +410,7 @@ void Module::removeFile(FileUnit &existingFile) {
   // Adjust for the std::reverse_iterator offset.
   ++I;
   Files.erase(I.base());
+  ++TopLevelDeclGeneration;
 }
 
 DerivedFileUnit &Module::getDerivedFileUnit() const {
@@ -1455,6 +1479,25 @@ SourceFile::getCachedVisibleDecls() const {
   return getCache().AllVisibleValues;
 }
 
+void SourceFile::cacheUnqualifiedLookup(DeclName name, unsigned options,
+                                        ArrayRef<ValueDecl *> results) const {
+  auto &cache = getCache();
+  cache.checkModuleDecls(*this);
+  auto &cached = cache.UnqualifiedResults[{name, options}];
+  cached.assign(results.begin(), results.end());
+}
+
+const SmallVectorImpl<ValueDecl *> *
+SourceFile::getCachedUnqualifiedLookup(DeclName name, unsigned options) const {
+  auto &cache = getCache();
+  cache.checkModuleDecls(*this);
+  auto &results = cache.UnqualifiedResults;
+  auto known = results.find({name, options});
+  if (known == results.end())
+    return nullptr;
+  return &known->second;
+}
+
 static void performAutoImport(SourceFile &SF,
                               SourceFile::ImplicitModuleImportKind modImpKind) {
   if (SF.Kind == SourceFileKind::SIL)
@@ -25,10 +25,18 @@
 #include "swift/Basic/SourceManager.h"
 #include "swift/Basic/STLExtras.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/TinyPtrVector.h"
 
 using namespace swift;
 
+#define DEBUG_TYPE "Name lookup"
+
+STATISTIC(NumUnqualifiedLookupCacheHits,
+          "# of top-level unqualified lookups found in the per-file cache");
+STATISTIC(NumUnqualifiedLookupCacheMisses,
+          "# of top-level unqualified lookups added to the per-file cache");
+
 void DebuggerClient::anchor() {}
 
 void AccessFilteringDeclConsumer::foundDecl(ValueDecl *D,
@@ -372,6 +380,24 @@ static void recordLookupOfTopLevelName(DeclContext *topLevelContext,
   nameTracker->addTopLevelName(name.getBaseName(), isCascading);
 }
 
+/// Returns the file whose cache can answer an unqualified lookup which has
+/// reached the module-scope context \p DC, or null if the lookup must be
+/// performed from scratch.
+static const SourceFile *getUnqualifiedLookupCacheFile(DeclContext *DC,
+                                                       DebuggerClient *Client) {
+  // The debugger can make new declarations visible at any time.
+  if (Client)
+    return nullptr;
+
+  // Declarations are added to REPL input as it is type-checked, and other
+  // files are still being parsed until name binding has finished.
+  auto SF = dyn_cast<SourceFile>(DC);
+  if (!SF || SF->Kind == SourceFileKind::REPL ||
+      SF->ASTStage < SourceFile::NameBound)
+    return nullptr;
+  return SF;
+}
+
 UnqualifiedLookup::UnqualifiedLookup(DeclName Name, DeclContext *DC,
                                      LazyResolver *TypeResolver,
                                      bool IsKnownNonCascading,
@@ -614,17 +640,37 @@ UnqualifiedLookup::UnqualifiedLookup(DeclName Name, DeclContext *DC,
 
   recordLookupOfTopLevelName(DC, Name, isCascadingUse.getValue());
 
-  // Add private imports to the extra search list.
-  SmallVector<Module::ImportedModule, 8> extraImports;
-  if (auto FU = dyn_cast<FileUnit>(DC))
-    FU->getImportedModules(extraImports, Module::ImportFilter::Private);
+  // From here on the results only depend on the file, the name, and the
+  // kind of lookup, so repeated lookups of common names like 'Int' can be
+  // answered from the file's cache. DC is now the file itself, and the
+  // source location no longer matters; the cache is keyed on the rest.
+  const SourceFile *CacheSF = getUnqualifiedLookupCacheFile(DC, DebugClient);
+  unsigned CacheOptions = (IsTypeLookup ? 1 : 0) | (TypeResolver ? 2 : 0);
+  const SmallVectorImpl<ValueDecl *> *CachedResults = nullptr;
+  if (CacheSF)
+    CachedResults = CacheSF->getCachedUnqualifiedLookup(Name, CacheOptions);
 
-  using namespace namelookup;
   SmallVector<ValueDecl *, 8> CurModuleResults;
-  auto resolutionKind =
-    IsTypeLookup ? ResolutionKind::TypesOnly : ResolutionKind::Overloadable;
-  lookupInModule(&M, {}, Name, CurModuleResults, NLKind::UnqualifiedLookup,
-                 resolutionKind, TypeResolver, DC, extraImports);
+  if (CachedResults) {
+    ++NumUnqualifiedLookupCacheHits;
+    CurModuleResults.append(CachedResults->begin(), CachedResults->end());
+  } else {
+    // Add private imports to the extra search list.
+    SmallVector<Module::ImportedModule, 8> extraImports;
+    if (auto FU = dyn_cast<FileUnit>(DC))
+      FU->getImportedModules(extraImports, Module::ImportFilter::Private);
+
+    using namespace namelookup;
+    auto resolutionKind =
+      IsTypeLookup ? ResolutionKind::TypesOnly : ResolutionKind::Overloadable;
+    lookupInModule(&M, {}, Name, CurModuleResults, NLKind::UnqualifiedLookup,
+                   resolutionKind, TypeResolver, DC, extraImports);
+
+    if (CacheSF) {
+      ++NumUnqualifiedLookupCacheMisses;
+      CacheSF->cacheUnqualifiedLookup(Name, CacheOptions, CurModuleResults);
+    }
+  }
 
   for (auto VD : CurModuleResults)
     Results.push_back(UnqualifiedLookupResult(VD));
@@ -150,7 +150,6 @@ RawComment Decl::getRawComment() const {
   if (auto *Unit =
           dyn_cast<FileUnit>(this->getDeclContext()->getModuleScopeContext())) {
     if (Optional<BriefAndRawComment> C = Unit->getCommentForDecl(this)) {
-      llvm::markup::MarkupContext MC;
       Context.setBriefComment(this, C->Brief);
       Context.setRawComment(this, C->Raw);
       return C->Raw;
@@ -168,8 +167,7 @@ static StringRef extractBriefComment(ASTContext &Context, RawComment RC,
   if (!canHaveComment(D))
     return StringRef();
 
-  llvm::markup::MarkupContext MC;
-  auto DC = getDocComment(MC, D);
+  auto DC = D->getDocComment();
   if (!DC.hasValue())
     return StringRef();
 
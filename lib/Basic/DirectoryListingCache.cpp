@@ -0,0 +1,315 @@
+//===--- DirectoryListingCache.cpp - Cached search path listings ----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/DirectoryListingCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace swift;
+namespace fs = llvm::sys::fs;
+namespace path = llvm::sys::path;
+
+#define DEBUG_TYPE "Directory listing cache"
+STATISTIC(NumDirectoriesListed, "# of directories listed");
+STATISTIC(NumListingsLoaded, "# of directory listings loaded from a file");
+STATISTIC(NumStaleListings,
+          "# of loaded directory listings dropped as out of date");
+STATISTIC(NumLookupsRuledOut,
+          "# of file system lookups avoided using directory listings");
+STATISTIC(NumLookupsNotRuledOut,
+          "# of file system lookups not ruled out by directory listings");
+
+/// The first line of a saved listings file.
+static const char ListingsFileSignature[] = "swift-directory-listings-1";
+
+/// Strips trailing separators, so that "dir" and "dir/" share a listing.
+static StringRef getDirectoryKey(StringRef dir) {
+  while (dir.size() > 1 && path::is_separator(dir.back()))
+    dir = dir.drop_back();
+  return dir;
+}
+
+/// Returns true if \p name can be looked up in a listing.
+///
+/// File systems may match names case-insensitively, or after Unicode
+/// normalization.  Listings store lowercased names to handle the former, and
+/// never rule out names that aren't ASCII to handle the latter.
+static bool canRuleOut(StringRef name) {
+  if (name.empty() || name == "." || name == "..")
+    return false;
+  for (char c : name)
+    if (static_cast<unsigned char>(c) >= 0x80)
+      return false;
+  return true;
+}
+
+/// Returns true if \p dir still has the modification time \p modTime, or
+/// still doesn't exist if \p exists is false.
+static bool isCurrent(StringRef dir, const llvm::sys::TimeValue &modTime,
+                      bool exists) {
+  fs::file_status status;
+  std::error_code err = fs::status(dir, status);
+  if (!exists)
+    return err == std::errc::no_such_file_or_directory;
+  return !err && fs::is_directory(status) &&
+         status.getLastModificationTime() == modTime;
+}
+
+DirectoryListingCache &DirectoryListingCache::get() {
+  static DirectoryListingCache cache;
+  return cache;
+}
+
+const DirectoryListingCache::Listing *
+DirectoryListingCache::getListing(StringRef dir, bool listIfNeeded) {
+  auto known = Listings.find(dir);
+  if (known != Listings.end())
+    return &known->getValue();
+  if (!listIfNeeded)
+    return nullptr;
+
+  Listing listing;
+  fs::file_status status;
+  std::error_code err = fs::status(dir, status);
+  if (err) {
+    // A directory that doesn't exist contains nothing. For other errors, let
+    // the caller look and report them.
+    if (err != std::errc::no_such_file_or_directory)
+      return nullptr;
+  } else {
+    if (!fs::is_directory(status))
+      return nullptr;
+
+    listing.Exists = true;
+    listing.ModTime = status.getLastModificationTime();
+
+    // Some file systems only record modification times to the second, or
+    // two. If the directory changes again within that time, its
+    // modification time might not change.
+    listing.IsRacy = llvm::sys::TimeValue::now().seconds() <
+                     listing.ModTime.seconds() + 2;
+    for (fs::directory_iterator entry(dir, err), end; !err && entry != end;
+         entry.increment(err)) {
+      listing.Names.insert(path::filename(entry->path()).lower());
+    }
+    if (err)
+      return nullptr;
+  }
+
+  ++NumDirectoriesListed;
+  HasNewListings = true;
+  Listing &result = Listings[dir];
+  result = std::move(listing);
+  return &result;
+}
+
+void DirectoryListingCache::listDirectory(StringRef dir) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  (void)getListing(getDirectoryKey(dir), /*listIfNeeded=*/true);
+}
+
+bool DirectoryListingCache::mayContain(StringRef dir, StringRef name) {
+  if (canRuleOut(name)) {
+    std::lock_guard<std::mutex> lock(Mutex);
+    const Listing *listing = getListing(getDirectoryKey(dir),
+                                        /*listIfNeeded=*/true);
+    if (listing &&
+        (!listing->Exists || !listing->Names.count(name.lower()))) {
+      ++NumLookupsRuledOut;
+      return false;
+    }
+  }
+
+  ++NumLookupsNotRuledOut;
+  return true;
+}
+
+bool DirectoryListingCache::mayExist(StringRef filePath) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (Listings.empty())
+    return true;
+
+  // Find the innermost listed ancestor, and check that it contains the next
+  // component of the path.
+  StringRef child = getDirectoryKey(filePath);
+  for (StringRef parent = getDirectoryKey(path::parent_path(child));
+       !parent.empty() && parent != child;
+       child = parent, parent = getDirectoryKey(path::parent_path(parent))) {
+    const Listing *listing = getListing(parent, /*listIfNeeded=*/false);
+    if (!listing)
+      continue;
+
+    StringRef name = path::filename(child);
+    if (canRuleOut(name) &&
+        (!listing->Exists || !listing->Names.count(name.lower()))) {
+      ++NumLookupsRuledOut;
+      return false;
+    }
+    break;
+  }
+
+  return true;
+}
+
+void DirectoryListingCache::removeStaleListings() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  SmallVector<std::string, 4> staleDirs;
+  for (auto &entry : Listings) {
+    const Listing &listing = entry.getValue();
+    if (listing.IsRacy ||
+        !isCurrent(entry.getKey(), listing.ModTime, listing.Exists))
+      staleDirs.push_back(entry.getKey().str());
+  }
+
+  NumStaleListings += staleDirs.size();
+  for (auto &dir : staleDirs)
+    Listings.erase(dir);
+}
+
+// A saved listings file starts with ListingsFileSignature, followed by one
+// record per directory:
+//
+//   missing <directory>
+//
+// for a directory that does not exist, or
+//
+//   listed <seconds> <nanoseconds> <entry count> <directory>
+//
+// followed by one line per entry.
+
+std::error_code DirectoryListingCache::load(StringRef file) {
+  auto bufferOrErr = llvm::MemoryBuffer::getFile(file);
+  if (!bufferOrErr)
+    return bufferOrErr.getError();
+
+  auto malformed = std::make_error_code(std::errc::invalid_argument);
+  StringRef rest = bufferOrErr.get()->getBuffer();
+  StringRef line;
+  std::tie(line, rest) = rest.split('\n');
+  if (line != ListingsFileSignature)
+    return malformed;
+
+  std::lock_guard<std::mutex> lock(Mutex);
+  while (!rest.empty()) {
+    std::tie(line, rest) = rest.split('\n');
+
+    StringRef kind, dir;
+    std::tie(kind, dir) = line.split(' ');
+    Listing listing;
+    size_t numEntries = 0;
+    if (kind == "listed") {
+      StringRef seconds, nanoseconds, count;
+      std::tie(seconds, dir) = dir.split(' ');
+      std::tie(nanoseconds, dir) = dir.split(' ');
+      std::tie(count, dir) = dir.split(' ');
+      llvm::sys::TimeValue::SecondsType parsedSeconds;
+      llvm::sys::TimeValue::NanoSecondsType parsedNanoseconds;
+      if (seconds.getAsInteger(10, parsedSeconds) ||
+          nanoseconds.getAsInteger(10, parsedNanoseconds) ||
+          count.getAsInteger(10, numEntries))
+        return malformed;
+      listing.Exists = true;
+      listing.ModTime = llvm::sys::TimeValue(parsedSeconds, parsedNanoseconds);
+    } else if (kind != "missing") {
+      return malformed;
+    }
+    if (dir.empty())
+      return malformed;
+
+    for (size_t i = 0; i != numEntries; ++i) {
+      if (rest.empty())
+        return malformed;
+      std::tie(line, rest) = rest.split('\n');
+      listing.Names.insert(line);
+    }
+
+    // Directories listed by this process are at least as current.
+    if (Listings.count(dir))
+      continue;
+
+    if (!isCurrent(dir, listing.ModTime, listing.Exists)) {
+      ++NumStaleListings;
+      continue;
+    }
+
+    ++NumListingsLoaded;
+    Listings[dir] = std::move(listing);
+  }
+
+  return std::error_code();
+}
+
+std::error_code DirectoryListingCache::save(StringRef file) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (!HasNewListings)
+    return std::error_code();
+
+  // Write to a temporary file, and rename it into place, so that readers
+  // never see a partially-written file.
+  llvm::SmallString<128> tmpName(file);
+  tmpName += "-%%%%%%";
+  int tmpFD;
+  if (auto err = fs::createUniqueFile(tmpName.str(), tmpFD, tmpName))
+    return err;
+
+  {
+    llvm::raw_fd_ostream out(tmpFD, /*shouldClose=*/true);
+    out << ListingsFileSignature << '\n';
+    for (auto &entry : Listings) {
+      StringRef dir = entry.getKey();
+      const Listing &listing = entry.getValue();
+      if (listing.IsRacy)
+        continue;
+
+      // Names with line breaks can't be saved; such directories will be
+      // listed again by whoever needs them.
+      auto hasLineBreak = [](StringRef name) {
+        return name.find_first_of("\r\n") != StringRef::npos;
+      };
+      bool canSave = !hasLineBreak(dir);
+      for (auto &name : listing.Names)
+        canSave = canSave && !hasLineBreak(name.getKey());
+      if (!canSave)
+        continue;
+
+      if (!listing.Exists) {
+        out << "missing " << dir << '\n';
+        continue;
+      }
+
+      out << "listed " << listing.ModTime.seconds() << ' '
+          << listing.ModTime.nanoseconds() << ' ' << listing.Names.size()
+          << ' ' << dir << '\n';
+      for (auto &name : listing.Names)
+        out << name.getKey() << '\n';
+    }
+
+    out.flush();
+    if (out.has_error()) {
+      out.clear_error();
+      fs::remove(tmpName.str());
+      return std::make_error_code(std::errc::io_error);
+    }
+  }
+
+  if (auto err = fs::rename(tmpName.str(), file)) {
+    fs::remove(tmpName.str());
+    return err;
+  }
+
+  HasNewListings = false;
+  return std::error_code();
+}
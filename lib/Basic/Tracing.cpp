@@ -0,0 +1,251 @@
+//===--- Tracing.cpp - Low-overhead timed spans ---------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/Tracing.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <pthread.h>
+
+using namespace swift;
+using namespace swift::tracing;
+
+std::atomic<bool> tracing::detail::Enabled(false);
+
+namespace {
+/// A recorded span.
+///
+/// The fields are atomic only so that writeChromeTrace() can read a span
+/// while its thread overwrites it; it then detects and drops the span.
+struct Span {
+  std::atomic<const char *> Name;
+  std::atomic<const char *> Category;
+  std::atomic<uint64_t> StartTime;
+  std::atomic<uint64_t> EndTime;
+};
+
+/// The spans recorded by one thread.
+///
+/// When a thread exits, its buffer is kept, so that its spans can still be
+/// written out, and is given to the next thread that records a span.  There
+/// are therefore only as many buffers as threads that have recorded spans at
+/// the same time, and threads that reuse a buffer share its ID in the trace.
+struct ThreadBuffer {
+  Span Spans[SpansPerThread];
+
+  /// The number of spans ever recorded; the most recent is at index
+  /// (NumRecorded - 1) % SpansPerThread.  Only the owning thread writes this.
+  std::atomic<uint64_t> NumRecorded{0};
+
+  /// The number of spans whose recording has started.  This is one more than
+  /// NumRecorded while a span is being written.
+  std::atomic<uint64_t> NumStarted{0};
+
+  /// A small number identifying the buffer in the trace.
+  const unsigned ThreadID;
+
+  /// The next buffer in the list of all buffers.
+  ThreadBuffer *Next = nullptr;
+
+  /// The next buffer in the list of buffers no thread owns.
+  ThreadBuffer *NextFree = nullptr;
+
+  explicit ThreadBuffer(unsigned threadID) : ThreadID(threadID) {}
+};
+
+/// A copy of a span, taken by writeChromeTrace().
+struct SpanCopy {
+  const char *Name;
+  const char *Category;
+  uint64_t StartTime;
+  uint64_t EndTime;
+};
+} // end anonymous namespace
+
+static std::atomic<ThreadBuffer *> AllBuffers(nullptr);
+static std::atomic<unsigned> NumThreadBuffers(0);
+static LLVM_THREAD_LOCAL ThreadBuffer *CurrentThreadBuffer = nullptr;
+
+/// Guards FreeBuffers.
+static std::mutex FreeBuffersMutex;
+static ThreadBuffer *FreeBuffers = nullptr;
+
+/// Gives the buffer of an exiting thread to the free list.
+static void releaseThreadBuffer(void *buffer) {
+  auto *threadBuffer = static_cast<ThreadBuffer *>(buffer);
+  CurrentThreadBuffer = nullptr;
+  std::lock_guard<std::mutex> lock(FreeBuffersMutex);
+  threadBuffer->NextFree = FreeBuffers;
+  FreeBuffers = threadBuffer;
+}
+
+/// The key whose destructor releases a thread's buffer when it exits.
+static pthread_key_t getThreadBufferKey() {
+  static pthread_key_t key = [] {
+    pthread_key_t result;
+    pthread_key_create(&result, releaseThreadBuffer);
+    return result;
+  }();
+  return key;
+}
+
+static ThreadBuffer &getCurrentThreadBuffer() {
+  if (CurrentThreadBuffer)
+    return *CurrentThreadBuffer;
+
+  ThreadBuffer *buffer;
+  {
+    std::lock_guard<std::mutex> lock(FreeBuffersMutex);
+    buffer = FreeBuffers;
+    if (buffer)
+      FreeBuffers = buffer->NextFree;
+  }
+
+  if (!buffer) {
+    buffer = new ThreadBuffer(++NumThreadBuffers);
+    do {
+      buffer->Next = AllBuffers.load(std::memory_order_relaxed);
+    } while (!AllBuffers.compare_exchange_weak(buffer->Next, buffer,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+  }
+
+  pthread_setspecific(getThreadBufferKey(), buffer);
+  CurrentThreadBuffer = buffer;
+  return *buffer;
+}
+
+void tracing::enable() {
+  detail::Enabled.store(true, std::memory_order_relaxed);
+}
+
+void tracing::disable() {
+  detail::Enabled.store(false, std::memory_order_relaxed);
+}
+
+uint64_t tracing::now() {
+  auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch)
+      .count();
+}
+
+void tracing::recordSpan(const char *name, const char *category,
+                         uint64_t startTime, uint64_t endTime) {
+  ThreadBuffer &buffer = getCurrentThreadBuffer();
+  uint64_t index = buffer.NumRecorded.load(std::memory_order_relaxed);
+  buffer.NumStarted.store(index + 1, std::memory_order_relaxed);
+
+  // Make sure that a reader that sees any part of this span also sees that
+  // the span it replaces is gone; see copySpans().
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Span &span = buffer.Spans[index % SpansPerThread];
+  span.Name.store(name, std::memory_order_relaxed);
+  span.Category.store(category, std::memory_order_relaxed);
+  span.StartTime.store(startTime, std::memory_order_relaxed);
+  span.EndTime.store(endTime, std::memory_order_relaxed);
+  buffer.NumRecorded.store(index + 1, std::memory_order_release);
+}
+
+/// Copies the spans in \p buffer that are not being overwritten into
+/// \p spans.
+static void copySpans(const ThreadBuffer &buffer,
+                      SmallVectorImpl<SpanCopy> &spans) {
+  uint64_t end = buffer.NumRecorded.load(std::memory_order_acquire);
+  uint64_t begin = end > SpansPerThread ? end - SpansPerThread : 0;
+
+  size_t firstCopied = spans.size();
+  for (uint64_t i = begin; i != end; ++i) {
+    const Span &span = buffer.Spans[i % SpansPerThread];
+    spans.push_back({span.Name.load(std::memory_order_relaxed),
+                     span.Category.load(std::memory_order_relaxed),
+                     span.StartTime.load(std::memory_order_relaxed),
+                     span.EndTime.load(std::memory_order_relaxed)});
+  }
+
+  // If the thread started recording more spans while we were copying, the
+  // oldest copies may be torn. Once span N has been started, it may be
+  // partially written over span N - SpansPerThread.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t started = buffer.NumStarted.load(std::memory_order_relaxed);
+  if (started > begin + SpansPerThread) {
+    uint64_t numTorn = std::min(started - (begin + SpansPerThread),
+                                end - begin);
+    spans.erase(spans.begin() + firstCopied,
+                spans.begin() + firstCopied + numTorn);
+  }
+}
+
+/// Writes \p str as a JSON string.
+static void writeJSONString(raw_ostream &os, StringRef str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      os << llvm::format("\\u%04x", unsigned(c));
+    else
+      os << c;
+  }
+  os << '"';
+}
+
+/// Writes a time in nanoseconds as the microseconds Chrome traces use.
+static void writeMicroseconds(raw_ostream &os, uint64_t nanoseconds) {
+  os << nanoseconds / 1000 << '.'
+     << llvm::format("%03u", unsigned(nanoseconds % 1000));
+}
+
+void tracing::writeChromeTrace(raw_ostream &os) {
+  os << "{\"traceEvents\":[";
+
+  bool first = true;
+  SmallVector<SpanCopy, 256> spans;
+  for (auto *buffer = AllBuffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->Next) {
+    spans.clear();
+    copySpans(*buffer, spans);
+
+    for (const SpanCopy &span : spans) {
+      if (!first)
+        os << ',';
+      first = false;
+
+      os << "\n{\"name\":";
+      writeJSONString(os, span.Name);
+      os << ",\"cat\":";
+      writeJSONString(os, span.Category);
+      os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadID
+         << ",\"ts\":";
+      writeMicroseconds(os, span.StartTime);
+      os << ",\"dur\":";
+      writeMicroseconds(os, span.EndTime - span.StartTime);
+      os << '}';
+    }
+  }
+
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+std::error_code tracing::writeChromeTrace(StringRef path) {
+  std::error_code error;
+  llvm::raw_fd_ostream os(path, error, llvm::sys::fs::F_None);
+  if (error)
+    return error;
+  writeChromeTrace(os);
+  return std::error_code();
+}
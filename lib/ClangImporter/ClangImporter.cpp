@@ -27,6 +27,7 @@
 #include "swift/AST/Module.h"
 #include "swift/AST/NameLookup.h"
 #include "swift/AST/Types.h"
+#include "swift/Basic/DirectoryListingCache.h"
 #include "swift/Basic/Platform.h"
 #include "swift/Basic/Range.h"
 #include "swift/Basic/StringExtras.h"
@@ -37,6 +38,7 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Mangle.h"
 #include "clang/Basic/CharInfo.h"
+#include "clang/Basic/FileSystemStatCache.h"
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Basic/Module.h"
 #include "clang/Basic/TargetInfo.h"
@@ -52,13 +54,20 @@
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/Sema.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <memory>
 
 using namespace swift;
 
+#define DEBUG_TYPE "Clang module importer"
+STATISTIC(NumClangStats, "# of file system stats by Clang");
+STATISTIC(NumClangStatsAvoided,
+          "# of Clang file system stats avoided using directory listings");
+
 // Commonly-used Clang classes.
 using clang::CompilerInstance;
 using clang::CompilerInvocation;
@@ -207,6 +216,60 @@ private:
 };
 }
 
+namespace {
+/// Reports files as missing without touching the file system when a
+/// directory the DirectoryListingCache has listed shows they don't exist.
+///
+/// Listings are taken before Clang runs, so they don't show what Clang
+/// writes itself.  Paths in those directories, such as the module cache,
+/// are always looked up in the file system.
+class SearchPathStatCache : public clang::FileSystemStatCache {
+  /// The directories Clang writes to, both as given and made absolute.
+  SmallVector<std::string, 4> WrittenDirs;
+
+  /// Returns true if \p path is \p dir or is inside it.
+  static bool isWithin(StringRef path, StringRef dir) {
+    while (dir.size() > 1 && llvm::sys::path::is_separator(dir.back()))
+      dir = dir.drop_back();
+    if (dir.empty() || !path.startswith(dir))
+      return false;
+    return path.size() == dir.size() ||
+           llvm::sys::path::is_separator(path[dir.size()]);
+  }
+
+  bool isWritten(StringRef path) const {
+    return std::any_of(WrittenDirs.begin(), WrittenDirs.end(),
+                       [&](const std::string &dir) {
+      return isWithin(path, dir);
+    });
+  }
+
+  LookupResult getStat(const char *Path, clang::FileData &Data, bool isFile,
+                       std::unique_ptr<clang::vfs::File> *F,
+                       clang::vfs::FileSystem &FS) override {
+    if (!isWritten(Path) && !DirectoryListingCache::get().mayExist(Path)) {
+      ++NumClangStatsAvoided;
+      return CacheMissing;
+    }
+    ++NumClangStats;
+    return statChained(Path, Data, isFile, F, FS);
+  }
+
+public:
+  /// Creates a stat cache that never rules out paths inside \p writtenDirs.
+  explicit SearchPathStatCache(ArrayRef<StringRef> writtenDirs) {
+    for (StringRef dir : writtenDirs) {
+      if (dir.empty())
+        continue;
+      WrittenDirs.push_back(dir);
+      SmallString<128> absoluteDir(dir);
+      if (!llvm::sys::fs::make_absolute(absoluteDir) && absoluteDir != dir)
+        WrittenDirs.push_back(absoluteDir.str());
+    }
+  }
+};
+}
+
 void ClangImporter::Implementation::addBridgeHeaderTopLevelDecls(
     clang::Decl *D) {
   if (shouldIgnoreBridgeHeaderTopLevelDecl(D))
@@ -587,6 +650,18 @@ ClangImporter::create(ASTContext &ctx,
   if (!canBegin)
     return nullptr; // there was an error related to the compiler arguments.
 
+  // Header search looks in the same search paths as module lookup, so let it
+  // use their listings. Files in a virtual file system overlay don't show up
+  // in directory listings, so only do this when there are no overlays.
+  // Clang builds modules into the module cache during the job, which may be
+  // inside a search path.
+  auto &headerSearchOpts = instance.getHeaderSearchOpts();
+  if (headerSearchOpts.VFSOverlayFiles.empty()) {
+    StringRef writtenDirs[] = { headerSearchOpts.ModuleCachePath };
+    instance.getFileManager().addStatCache(
+      llvm::make_unique<SearchPathStatCache>(writtenDirs));
+  }
+
   clang::Preprocessor &clangPP = instance.getPreprocessor();
   clangPP.enableIncrementalProcessing();
 
@@ -612,11 +687,18 @@ ClangImporter::create(ASTContext &ctx,
   // We add search paths here instead of when building the initial invocation
   // so that (a) we use the same code as search paths for imported modules,
   // and (b) search paths are always added after -Xcc options.
+  // The search paths are listed up front so that header search can use their
+  // listings from the start.
   SearchPathOptions &searchPathOpts = ctx.SearchPathOpts;
-  for (auto path : searchPathOpts.FrameworkSearchPaths)
+  auto &listings = DirectoryListingCache::get();
+  for (auto path : searchPathOpts.FrameworkSearchPaths) {
+    listings.listDirectory(path);
     importer->addSearchPath(path, /*isFramework*/true);
-  for (auto path : searchPathOpts.ImportSearchPaths)
+  }
+  for (auto path : searchPathOpts.ImportSearchPaths) {
+    listings.listDirectory(path);
     importer->addSearchPath(path, /*isFramework*/false);
+  }
 
   clang::Parser::DeclGroupPtrTy parsed;
   while (!importer->Impl.Parser->ParseTopLevelDecl(parsed)) {
@@ -22,6 +22,7 @@
 #include "swift/AST/DiagnosticsFrontend.h"
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/AST/Module.h"
+#include "swift/Basic/DirectoryListingCache.h"
 #include "swift/Basic/SourceManager.h"
 #include "swift/Parse/DelayedParsingCallbacks.h"
 #include "swift/Parse/Lexer.h"
@@ -79,6 +80,15 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
                                Invocation.getSearchPathOptions(),
                                SourceMgr, Diagnostics));
 
+  // Drop search path listings from earlier compiles in this process that are
+  // out of date, and use those saved by other jobs. If there are none yet,
+  // or they can't be read, the search paths are listed as they're needed.
+  DirectoryListingCache::get().removeStaleListings();
+  const std::string &listingCachePath =
+    Invocation.getSearchPathOptions().SearchPathListingCachePath;
+  if (!listingCachePath.empty())
+    (void)DirectoryListingCache::get().load(listingCachePath);
+
   if (Invocation.getFrontendOptions().EnableSourceImport) {
     bool immediate = Invocation.getFrontendOptions().actionIsImmediate();
     Context->addModuleLoader(SourceLoader::create(*Context, !immediate,
@@ -432,6 +442,9 @@ void CompilerInstance::performSema() {
   if (Invocation.getFrontendOptions().DebugTimeFunctionBodies) {
     TypeCheckOptions |= TypeCheckingFlags::DebugTimeFunctionBodies;
   }
+  if (Invocation.getFrontendOptions().DebugTimeExpressionDiagnosis) {
+    TypeCheckOptions |= TypeCheckingFlags::DebugTimeExpressionDiagnosis;
+  }
   if (Invocation.getFrontendOptions().actionIsImmediate()) {
     TypeCheckOptions |= TypeCheckingFlags::ForImmediateMode;
   }
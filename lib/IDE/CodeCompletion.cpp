@@ -241,8 +241,7 @@ void getSwiftDocKeyword(const Decl* D, CommandWordsPairs &Words) {
   }
   if (!Interested)
     return;
-  static llvm::markup::MarkupContext MC;
-  auto DC = getDocComment(MC, D);
+  auto DC = D->getDocComment();
   if (!DC.hasValue())
     return;
   SwiftDocWordExtractor Extractor(Words);
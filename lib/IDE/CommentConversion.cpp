@@ -416,8 +416,7 @@ bool ide::getDocumentationCommentAsXML(const Decl *D, raw_ostream &OS) {
     return false;
   }
 
-  llvm::markup::MarkupContext MC;
-  auto DC = getDocComment(MC, D);
+  auto DC = D->getDocComment();
   if (!DC.hasValue())
     return false;
 
@@ -1435,7 +1435,8 @@ Address irgen::emitBoxedExistentialContainerAllocation(IRGenFunction &IGF,
                                   SILType destType,
                                   CanType formalSrcType,
                                   SILType loweredSrcType,
-                                  ArrayRef<ProtocolConformance *> conformances){
+                                  ArrayRef<ProtocolConformance *> conformances,
+                                  llvm::Value *initialValue) {
   // TODO: Non-ErrorType boxed existentials.
   assert(_isErrorType(destType));
 
@@ -1450,12 +1451,17 @@ Address irgen::emitBoxedExistentialContainerAllocation(IRGenFunction &IGF,
                                          entry, conformances[0]);
   
   // Call the runtime to allocate the box.
-  // TODO: When there's a store or copy_addr immediately into the box, peephole
-  // it into the initializer parameter to allocError.
+  // TODO: Peephole copy_addr into the box into the initializer parameter too;
+  // for now, only the stores IRGenSIL forwards here are.
+  llvm::Value *isTake = llvm::ConstantInt::get(IGF.IGM.Int1Ty,
+                                               initialValue != nullptr);
+  if (initialValue)
+    initialValue = IGF.Builder.CreateBitCast(initialValue,
+                                             IGF.IGM.OpaquePtrTy);
+  else
+    initialValue = llvm::ConstantPointerNull::get(IGF.IGM.OpaquePtrTy);
   auto result = IGF.Builder.CreateCall(IGF.IGM.getAllocErrorFn(),
-                         {srcMetadata, witness,
-                           llvm::ConstantPointerNull::get(IGF.IGM.OpaquePtrTy),
-                           llvm::ConstantInt::get(IGF.IGM.Int1Ty, 0)});
+                         {srcMetadata, witness, initialValue, isTake});
   
   // Extract the box and value address from the result.
   auto box = IGF.Builder.CreateExtractValue(result, 0);
@@ -64,12 +64,17 @@ namespace irgen {
 
   /// Allocate a boxed existential container with uninitialized space to hold a
   /// value of a given type.
+  ///
+  /// If \p initialValue is non-null, it is the address of a value of the
+  /// source type, which is taken into the box. The returned address must then
+  /// not be written to, since the runtime may hand out a shared box.
   Address emitBoxedExistentialContainerAllocation(IRGenFunction &IGF,
                                   Explosion &dest,
                                   SILType destType,
                                   CanType formalSrcType,
                                   SILType loweredSrcType,
-                                  ArrayRef<ProtocolConformance *> conformances);
+                                  ArrayRef<ProtocolConformance *> conformances,
+                                  llvm::Value *initialValue = nullptr);
   
   /// "Deinitialize" an existential container whose contained value is allocated
   /// but uninitialized, by deallocating the buffer owned by the container if any.
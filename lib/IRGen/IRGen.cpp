@@ -23,6 +23,7 @@
 #include "swift/SIL/SILModule.h"
 #include "swift/Basic/Dwarf.h"
 #include "swift/Basic/Platform.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/LLVMPasses/PassesFwd.h"
 #include "swift/LLVMPasses/Passes.h"
@@ -204,6 +205,7 @@ static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
                         llvm::Module *Module,
                         llvm::TargetMachine *TargetMachine,
                         StringRef OutputFilename) {
+  tracing::TracedSpan Span("LLVM", "frontend");
   llvm::SmallString<0> Buffer;
   std::unique_ptr<raw_pwrite_stream> RawOS;
   if (!OutputFilename.empty()) {
@@ -390,6 +392,7 @@ static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
                                                  llvm::LLVMContext &LLVMContext,
                                                        SourceFile *SF = nullptr,
                                                        unsigned StartElem = 0) {
+  tracing::TracedSpan Span("IRGen", "frontend");
   auto &Ctx = M->getASTContext();
   assert(!Ctx.hadError());
 
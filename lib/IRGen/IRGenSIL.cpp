@@ -293,6 +293,10 @@ public:
   /// All alloc_ref instructions which allocate the object on the stack.
   llvm::SmallPtrSet<SILInstruction *, 8> StackAllocs;
 
+  /// Stores into error boxes whose value was already passed to
+  /// swift_allocError when allocating the box.
+  llvm::SmallPtrSet<SILInstruction *, 4> ForwardedErrorBoxStores;
+
   /// Accumulative amount of allocated bytes on the stack. Used to limit the
   /// size for stack promoted objects.
   /// We calculate it on demand, so that we don't have to do it if the
@@ -2684,7 +2688,119 @@ void IRGenSILFunction::visitSelectEnumAddrInst(SelectEnumAddrInst *inst) {
                   getLoweredValueForSelect(*this, result, inst));
 }
 
+/// The smallest select_value that is lowered to a lookup table.
+static const unsigned MinLookupTableCases = 4;
+
+/// The largest lookup table, in entries, that a select_value is lowered to.
+static const uint64_t MaxLookupTableSize = 1024;
+
+// Try to lower a select_value whose case values and results are all integer
+// literals to a load from a table of the results in constant data. This is
+// what SwitchFormation produces for a switch whose cases only compute a value,
+// e.g. mapping an opcode to its operand count.
+static llvm::Value *
+emitSelectValueAsLookupTable(IRGenSILFunction &IGF, SelectValueInst *inst) {
+  if (inst->getNumCases() < MinLookupTableCases || !inst->hasDefault())
+    return nullptr;
+
+  auto operandTy = inst->getOperand().getType().getAs<BuiltinIntegerType>();
+  if (!operandTy || !operandTy->isFixedWidth() ||
+      operandTy->getFixedWidth() > 64)
+    return nullptr;
+
+  // The result must be a single integer scalar.
+  auto &ti = IGF.getTypeInfo(inst->getType());
+  ExplosionSchema schema = ti.getSchema();
+  if (schema.size() != 1 || !schema[0].isScalar())
+    return nullptr;
+  auto *resultType = dyn_cast<llvm::IntegerType>(schema[0].getScalarType());
+  if (!resultType)
+    return nullptr;
+
+  auto getResult = [&](SILValue v) -> llvm::Constant * {
+    auto *intLit = dyn_cast<IntegerLiteralInst>(v.getDef());
+    if (!intLit)
+      return nullptr;
+    llvm::Constant *c = getConstantInt(IGF.IGM, intLit);
+    return c->getType() == resultType ? c : nullptr;
+  };
+
+  llvm::Constant *defaultResult = getResult(inst->getDefaultResult());
+  if (!defaultResult)
+    return nullptr;
+
+  // Collect the cases and find the range they cover.
+  SmallVector<std::pair<APInt, llvm::Constant *>, 16> entries;
+  APInt minValue, maxValue;
+  for (unsigned i = 0, e = inst->getNumCases(); i < e; ++i) {
+    auto casePair = inst->getCase(i);
+    auto *caseLit = dyn_cast<IntegerLiteralInst>(casePair.first.getDef());
+    llvm::Constant *result = getResult(casePair.second);
+    if (!caseLit || !result)
+      return nullptr;
+    APInt caseValue =
+      caseLit->getValue().sextOrTrunc(operandTy->getFixedWidth());
+    if (entries.empty() || caseValue.slt(minValue))
+      minValue = caseValue;
+    if (entries.empty() || caseValue.sgt(maxValue))
+      maxValue = caseValue;
+    entries.push_back({caseValue, result});
+  }
+
+  // Only use a table if it is small, and at least half of it comes from the
+  // cases themselves; otherwise the LLVM switch does just as well.
+  APInt span = maxValue - minValue;
+  if (span.uge(MaxLookupTableSize))
+    return nullptr;
+  uint64_t tableSize = span.getZExtValue() + 1;
+  if (entries.size() * 2 < tableSize)
+    return nullptr;
+
+  SmallVector<llvm::Constant *, 16> elts(tableSize, defaultResult);
+  for (auto &entry : entries)
+    elts[(entry.first - minValue).getZExtValue()] = entry.second;
+
+  auto *tableTy = llvm::ArrayType::get(resultType, tableSize);
+  auto *table = new llvm::GlobalVariable(IGF.IGM.Module, tableTy,
+                                         /*constant*/ true,
+                                         llvm::GlobalValue::PrivateLinkage,
+                                         llvm::ConstantArray::get(tableTy, elts),
+                                         "switch.table");
+  table->setUnnamedAddr(true);
+
+  // Rebase the operand to the start of the table. Values below the minimum
+  // wrap around to large unsigned values, so one unsigned comparison checks
+  // both ends of the range.
+  Explosion value = IGF.getLoweredExplosion(inst->getOperand());
+  llvm::Value *operand = value.claimNext();
+  llvm::Value *index =
+    IGF.Builder.CreateSub(operand, llvm::ConstantInt::get(IGF.IGM.LLVMContext,
+                                                          minValue));
+  llvm::Value *inRange =
+    IGF.Builder.CreateICmpULE(index, llvm::ConstantInt::get(IGF.IGM.LLVMContext,
+                                                            span));
+
+  // Clamp the index so that the load is always in bounds, and pick the
+  // default result for operands outside the table.
+  index = IGF.Builder.CreateSelect(inRange, index,
+                                   llvm::ConstantInt::get(index->getType(), 0));
+  index = IGF.Builder.CreateZExtOrTrunc(index, IGF.IGM.SizeTy);
+  llvm::Value *indices[] = { llvm::ConstantInt::get(IGF.IGM.SizeTy, 0), index };
+  llvm::Value *addr = IGF.Builder.CreateInBoundsGEP(tableTy, table, indices);
+  Alignment align(IGF.IGM.DataLayout.getABITypeAlignment(resultType));
+  llvm::Value *result = IGF.Builder.CreateLoad(addr, align);
+  return IGF.Builder.CreateSelect(inRange, result, defaultResult);
+}
+
 void IRGenSILFunction::visitSelectValueInst(SelectValueInst *inst) {
+  if (llvm::Value *R = emitSelectValueAsLookupTable(*this, inst)) {
+    Explosion result;
+    result.add(R);
+    setLoweredValue(SILValue(inst, 0),
+                    getLoweredValueForSelect(*this, result, inst));
+    return;
+  }
+
   Explosion value = getLoweredExplosion(inst->getOperand());
 
   // Map the SIL dest bbs to their LLVM bbs.
@@ -2925,6 +3041,9 @@ void IRGenSILFunction::visitLoadInst(swift::LoadInst *i) {
 }
 
 void IRGenSILFunction::visitStoreInst(swift::StoreInst *i) {
+  if (ForwardedErrorBoxStores.count(i))
+    return;
+
   Explosion source = getLoweredExplosion(i->getSrc());
   Address dest = getLoweredAddress(i->getDest());
   auto &type = getTypeInfo(i->getSrc().getType().getObjectType());
@@ -4257,12 +4376,56 @@ void IRGenSILFunction::visitInitBlockStorageHeaderInst(
   setLoweredExplosion(SILValue(i, 0), e);
 }
 
+/// Returns the store which immediately initializes the box allocated by \p i
+/// with a value of an enum without payloads, or null if there is none.
+///
+/// The runtime can hand out a shared, preallocated box for such a value
+/// instead of allocating one, if it is given the value up front.
+static StoreInst *getEmptyEnumErrorBoxStore(IRGenModule &IGM,
+                                            AllocExistentialBoxInst *i) {
+  auto *enumDecl = i->getFormalConcreteType()->getEnumOrBoundGenericEnum();
+  if (!enumDecl || !enumDecl->hasOnlyCasesWithoutAssociatedValues())
+    return nullptr;
+  if (!IGM.isPOD(i->getLoweredConcreteType(), ResilienceScope::Component))
+    return nullptr;
+
+  auto next = std::next(SILBasicBlock::iterator(i));
+  if (next == i->getParent()->end())
+    return nullptr;
+  auto *store = dyn_cast<StoreInst>(next);
+  if (!store || store->getDest() != i->getValueAddressResult())
+    return nullptr;
+  return store;
+}
+
 void IRGenSILFunction::visitAllocExistentialBoxInst(AllocExistentialBoxInst *i){
   Explosion box;
+  auto concreteType = i->getLoweredConcreteType();
+
+  // Pass the stored value to the runtime as the initial value of the box.
+  if (auto *store = getEmptyEnumErrorBoxStore(IGM, i)) {
+    auto &valueTI = cast<LoadableTypeInfo>(getTypeInfo(concreteType));
+    Explosion value = getLoweredExplosion(store->getSrc());
+    auto temp = valueTI.allocateStack(*this, concreteType, "error.value");
+    valueTI.initialize(*this, value, temp.getAddress());
+    auto projectionAddr =
+      emitBoxedExistentialContainerAllocation(*this, box,
+                                              i->getExistentialType(),
+                                              i->getFormalConcreteType(),
+                                              concreteType,
+                                              i->getConformances(),
+                                              temp.getAddress().getAddress());
+    valueTI.deallocateStack(*this, temp.getContainer(), concreteType);
+    ForwardedErrorBoxStores.insert(store);
+    setLoweredExplosion(i->getExistentialResult(), box);
+    setLoweredAddress(i->getValueAddressResult(), projectionAddr);
+    return;
+  }
+
   auto projectionAddr =
     emitBoxedExistentialContainerAllocation(*this, box, i->getExistentialType(),
                                             i->getFormalConcreteType(),
-                                            i->getLoweredConcreteType(),
+                                            concreteType,
                                             i->getConformances());
   setLoweredExplosion(i->getExistentialResult(), box);
   setLoweredAddress(i->getValueAddressResult(), projectionAddr);
@@ -171,8 +171,7 @@ private:
   }
 
   void printDocumentationComment(Decl *D) {
-    llvm::markup::MarkupContext MC;
-    auto DC = getDocComment(MC, D);
+    auto DC = D->getDocComment();
     if (DC.hasValue())
       ide::getDocumentationCommentAsDoxygen(DC.getValue(), os);
   }
@@ -20,6 +20,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormattedStream.h"
+#include "llvm/Support/SaveAndRestore.h"
 #include "swift/AST/DiagnosticsSIL.h"
 #include "swift/AST/Pattern.h"
 #include "swift/AST/SILOptions.h"
@@ -411,6 +412,10 @@ class PatternMatchEmission {
   using CompletionHandlerTy =
     llvm::function_ref<void(PatternMatchEmission &, ClauseRow &)>;
   CompletionHandlerTy CompletionHandler;
+
+  /// True while emitting the rows of a string switch run; keeps us from
+  /// trying to hash-dispatch the same rows again.
+  bool InStringSwitchDispatch = false;
 public:
   
   PatternMatchEmission(SILGenFunction &SGF, Stmt *S,
@@ -430,6 +435,9 @@ public:
 private:
   void emitWildcardDispatch(ClauseMatrix &matrix, ArgArray args, unsigned row,
                             const FailureHandler &failure);
+  void emitStringSwitchDispatch(ClauseMatrix &matrix, ArgArray args,
+                                unsigned firstRow, unsigned endRow,
+                                const FailureHandler &failure);
 
   void bindRefutablePatterns(const ClauseRow &row, ArgArray args,
                              const FailureHandler &failure);
@@ -655,6 +663,16 @@ public:
     return innerMatrix;
   }
 
+  /// Create a clause matrix over the given rows of this matrix, in order.
+  /// The rows are shared with this matrix, so they must not be specialized
+  /// through the new one.
+  ClauseMatrix selectRows(ArrayRef<unsigned> rowIndices) const {
+    ClauseMatrix selectedMatrix;
+    for (unsigned index : rowIndices)
+      selectedMatrix.Rows.push_back(Rows[index]);
+    return selectedMatrix;
+  }
+
   LLVM_ATTRIBUTE_USED void dump() const { return print(llvm::errs()); }
   void print(llvm::raw_ostream &out) const;
 };
@@ -949,6 +967,92 @@ chooseNecessaryColumn(const ClauseMatrix &matrix, unsigned firstRow) {
   return bestColumn;
 }
 
+/// The minimum number of consecutive string literal rows that we dispatch
+/// on a hash of the subject instead of testing each row in turn.
+static const unsigned MinStringSwitchHashRows = 4;
+
+/// If the given row matches its only column against an ASCII string
+/// literal with the standard library's Equatable '~=', return the literal.
+static StringLiteralExpr *getStringSwitchLiteral(ASTContext &ctx,
+                                                 const ClauseRow &row) {
+  if (row.columns() != 1 || row.getCaseGuardExpr() || !row[0])
+    return nullptr;
+
+  auto *EP = dyn_cast<ExprPattern>(row[0]->getSemanticsProvidingPattern());
+  if (!EP || !EP->getMatchExpr() || !EP->getMatchVar())
+    return nullptr;
+  if (EP->getType()->getAnyNominal() != ctx.getStringDecl())
+    return nullptr;
+
+  // The match expression is 'literal ~= $match', converted to Builtin.Int1
+  // through BooleanType.
+  Expr *match = EP->getMatchExpr();
+  if (auto *call = dyn_cast<CallExpr>(match))
+    if (auto *memberRef = dyn_cast<MemberRefExpr>(call->getFn()))
+      match = memberRef->getBase();
+  auto *binary = dyn_cast<BinaryExpr>(match->getSemanticsProvidingExpr());
+  if (!binary)
+    return nullptr;
+
+  // A user-defined '~=' may not agree with '=='.
+  auto *fnRef =
+    dyn_cast<DeclRefExpr>(binary->getFn()->getSemanticsProvidingExpr());
+  if (!fnRef)
+    return nullptr;
+  auto *fn = dyn_cast<FuncDecl>(fnRef->getDecl());
+  if (!fn || fn->getName() != ctx.Id_MatchOperator ||
+      !fn->getModuleContext()->isStdlibModule() || !fn->getGenericParams())
+    return nullptr;
+
+  auto *args = dyn_cast<TupleExpr>(binary->getArg());
+  if (!args || args->getNumElements() != 2)
+    return nullptr;
+  auto *matchVarRef =
+    dyn_cast<DeclRefExpr>(args->getElement(1)->getSemanticsProvidingExpr());
+  if (!matchVarRef || matchVarRef->getDecl() != EP->getMatchVar())
+    return nullptr;
+  Expr *literalArg = args->getElement(0)->getSemanticsProvidingExpr();
+  auto *literal = dyn_cast<StringLiteralExpr>(literalArg);
+  if (!literal || literal->getType()->getAnyNominal() != ctx.getStringDecl())
+    return nullptr;
+
+  // A non-ASCII literal can be canonically equivalent to a subject with
+  // different code units, so it can't be found by hash.
+  for (unsigned char c : literal->getValue())
+    if (c >= 0x80)
+      return nullptr;
+
+  return literal;
+}
+
+/// Compute the dispatch hash of an ASCII string literal.  This must agree
+/// with _stringSwitchHash in stdlib/public/core/StringSwitch.swift.
+static uint32_t getStringSwitchHash(StringRef value) {
+  uint32_t hash = 2166136261u ^ uint32_t(value.size());
+  for (unsigned char c : value)
+    hash = (hash ^ c) * 16777619u;
+  return hash & 0x7fffffffu;
+}
+
+/// Return the end of the run of string literal rows beginning at firstRow
+/// that should be dispatched by hash, or firstRow if there is none.
+static unsigned getStringSwitchRunEnd(SILGenFunction &SGF,
+                                      const ClauseMatrix &clauses,
+                                      ArgArray args, unsigned firstRow) {
+  auto &ctx = SGF.getASTContext();
+  if (args.size() != 1 || !args[0].getType().isObject() ||
+      !ctx.getStringSwitchHash(nullptr))
+    return firstRow;
+
+  unsigned row = firstRow;
+  while (row != clauses.rows() && getStringSwitchLiteral(ctx, clauses[row]))
+    ++row;
+
+  if (row - firstRow < MinStringSwitchHashRows)
+    return firstRow;
+  return row;
+}
+
 /// Recursively emit a decision tree from the given pattern matrix.
 void PatternMatchEmission::emitDispatch(ClauseMatrix &clauses, ArgArray args,
                                         const FailureHandler &outerFailure) {
@@ -970,10 +1074,20 @@ void PatternMatchEmission::emitDispatch(ClauseMatrix &clauses, ArgArray args,
       SGF.Cleanups.emitBranchAndCleanups(scope.getExitDest(), loc);
     };
 
-    // If there is no necessary column, just emit the first row.
+    // If there is no necessary column, dispatch a run of string literal
+    // rows by hash if one starts here, or else just emit the first row.
     if (!column) {
-      unsigned wildcardRow = firstRow++;
-      emitWildcardDispatch(clauses, args, wildcardRow, innerFailure);
+      unsigned runEnd = InStringSwitchDispatch
+        ? firstRow : getStringSwitchRunEnd(SGF, clauses, args, firstRow);
+      if (runEnd != firstRow) {
+        unsigned runBegin = firstRow;
+        firstRow = runEnd;
+        emitStringSwitchDispatch(clauses, args, runBegin, runEnd,
+                                 innerFailure);
+      } else {
+        unsigned wildcardRow = firstRow++;
+        emitWildcardDispatch(clauses, args, wildcardRow, innerFailure);
+      }
     } else {
       // Otherwise, specialize on the necessary column.
       emitSpecializedDispatch(clauses, args, firstRow, column.getValue(),
@@ -1048,6 +1162,93 @@ void PatternMatchEmission::emitWildcardDispatch(ClauseMatrix &clauses,
   assert(!SGF.B.hasValidInsertionPoint());
 }
 
+/// Emit the decision tree for a run of rows that each match a single ASCII
+/// string literal.  Rather than testing the rows one after another, we
+/// switch on a hash of the subject and then test only the rows whose
+/// literal has the same hash.  If the subject is not known to be ASCII,
+/// we test every row of the run in order instead.
+///
+/// \param matrixArgs - appropriate for the entire clause matrix, not
+///   just these specific rows
+void PatternMatchEmission::emitStringSwitchDispatch(ClauseMatrix &clauses,
+                                                    ArgArray matrixArgs,
+                                                    unsigned firstRow,
+                                                    unsigned endRow,
+                                               const FailureHandler &failure) {
+  assert(matrixArgs.size() == 1 && "string switch run with several columns?");
+  llvm::SaveAndRestore<bool> inStringSwitch(InStringSwitchDispatch, true);
+  auto &Context = SGF.getASTContext();
+
+  SILLocation loc = PatternMatchStmt;
+  loc.setDebugLoc(clauses[firstRow].getCasePattern());
+
+  // Rows after the run still need the subject if nothing here matches.
+  ArgForwarder forwarder(SGF, matrixArgs,
+                         /*isFinalUse*/ endRow == clauses.rows());
+  ArgArray args = forwarder.getForwardedArgs();
+
+  // Bucket the rows by the hash of their literal.  Rows keep their
+  // relative order within a bucket.
+  llvm::MapVector<uint32_t, SmallVector<unsigned, 2>> buckets;
+  SmallVector<unsigned, 16> runRows;
+  for (unsigned row = firstRow; row != endRow; ++row) {
+    auto *literal = getStringSwitchLiteral(Context, clauses[row]);
+    assert(literal && "row is not part of a string switch run");
+    buckets[getStringSwitchHash(literal->getValue())].push_back(row);
+    runRows.push_back(row);
+  }
+
+  // Hash the subject and extract the Builtin.Int32 from the Int32 result.
+  ManagedValue subject =
+    args[0].getFinalManagedValue().copyUnmanaged(SGF, loc);
+  ManagedValue hash =
+    SGF.emitApplyOfLibraryIntrinsic(loc, Context.getStringSwitchHash(nullptr),
+                                    {}, subject, SGFContext());
+  SILValue hashValue = hash.getUnmanagedValue();
+  auto *hashStruct = hashValue.getType().getStructOrBoundGenericStruct();
+  assert(hashStruct && "_stringSwitchHash should return Int32");
+  auto *hashField = *hashStruct->getStoredProperties().begin();
+  auto *builtinHash = SGF.B.createStructExtract(loc, hashValue, hashField);
+  SILType hashTy = builtinHash->getType(0);
+
+  SILBasicBlock *curBB = SGF.B.getInsertionBB();
+  SmallVector<std::pair<SILValue, SILBasicBlock*>, 8> caseBBs;
+  caseBBs.reserve(buckets.size() + 1);
+  for (auto &bucket : buckets) {
+    curBB = SGF.createBasicBlock(curBB);
+    auto *IL = SGF.B.createIntegerLiteral(loc, hashTy, bucket.first);
+    caseBBs.push_back({SILValue(IL, 0), curBB});
+  }
+
+  // _stringSwitchHash returns -1 for subjects that may not be ASCII.
+  SILBasicBlock *unknownBB = SGF.createBasicBlock(curBB);
+  auto *unknownIL = SGF.B.createIntegerLiteral(loc, hashTy, -1);
+  caseBBs.push_back({SILValue(unknownIL, 0), unknownBB});
+
+  // An ASCII subject whose hash matches no literal matches no row.
+  SILBasicBlock *noMatchBB = SGF.createBasicBlock(unknownBB);
+
+  SGF.B.createSwitchValue(loc, SILValue(builtinHash, 0), noMatchBB, caseBBs);
+
+  // An ASCII subject is only equal to a literal with the same code units,
+  // so failing every row in its bucket means it fails the whole run.
+  unsigned caseIndex = 0;
+  for (auto &bucket : buckets) {
+    SGF.B.setInsertionPoint(caseBBs[caseIndex++].second);
+    ClauseMatrix bucketClauses = clauses.selectRows(bucket.second);
+    emitDispatch(bucketClauses, args, failure);
+    assert(!SGF.B.hasValidInsertionPoint() && "did not end block");
+  }
+
+  SGF.B.setInsertionPoint(unknownBB);
+  ClauseMatrix runClauses = clauses.selectRows(runRows);
+  emitDispatch(runClauses, args, failure);
+  assert(!SGF.B.hasValidInsertionPoint() && "did not end block");
+
+  SGF.B.setInsertionPoint(noMatchBB);
+  failure(loc);
+}
+
 /// Bind all the irrefutable patterns in the given row, which is
 /// nothing but wildcard patterns.
 void PatternMatchEmission::
@@ -2046,10 +2247,12 @@ void PatternMatchEmission::emitSharedCaseBlocks() {
 
     // If this case can only have one predecessor, then merge it into that
     // predecessor.  We rely on the SIL CFG here, because unemitted shared case
-    // blocks might fallthrough into this one.
-    if (!hasFallthroughTo && caseBlock->getCaseLabelItems().size() == 1) {
-      SILBasicBlock *predBB = caseBB->getSinglePredecessor();
-      assert(predBB && "Should only have 1 predecesor because it isn't shared");
+    // blocks might fallthrough into this one.  A case with a single label
+    // can still be reached along two paths if it is part of a string switch
+    // run, which is emitted both by hash and in order.
+    SILBasicBlock *predBB = caseBB->getSinglePredecessor();
+    if (!hasFallthroughTo && caseBlock->getCaseLabelItems().size() == 1 &&
+        predBB) {
       assert(isa<BranchInst>(predBB->getTerminator()) &&
              "Should have uncond branch to shared block");
       predBB->getTerminator()->eraseFromParent();
@@ -2061,8 +2264,7 @@ void PatternMatchEmission::emitSharedCaseBlocks() {
     } else {
       // Otherwise, move the block to after the first predecessor.
       assert(!caseBB->pred_empty() && "Emitted an unused shared block?");
-      auto predBB = *caseBB->pred_begin();
-      caseBB->moveAfter(predBB);
+      caseBB->moveAfter(*caseBB->pred_begin());
 
       // Then emit the case body into the caseBB.
       SGF.B.setInsertionPoint(caseBB);
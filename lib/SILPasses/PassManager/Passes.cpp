@@ -28,6 +28,7 @@
 #include "swift/SILAnalysis/Analysis.h"
 #include "swift/AST/ASTContext.h"
 #include "swift/AST/Module.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/SIL/SILModule.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
@@ -58,6 +59,8 @@ enum OptimizationLevelKind {
 };
 
 bool swift::runSILDiagnosticPasses(SILModule &Module) {
+  tracing::TracedSpan Span("SIL diagnostic passes", "frontend");
+
   // Verify the module, if required.
   if (Module.getOptions().VerifyAll)
     Module.verify();
@@ -223,6 +226,8 @@ void AddSSAPasses(SILPassManager &PM, OptimizationLevelKind OpLevel) {
 
 
 void swift::runSILOptimizationPasses(SILModule &Module) {
+  tracing::TracedSpan Span("SIL optimization passes", "frontend");
+
   // Verify the module, if required.
   if (Module.getOptions().VerifyAll)
     Module.verify();
@@ -351,6 +356,9 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   PM.addRedundantOverflowCheckRemoval();
   PM.addMergeCondFails();
 
+  // Turn chains of comparisons against constants into switches.
+  PM.addSwitchFormation();
+
   // Remove dead code.
   PM.addDCE();
   PM.addSimplifyCFG();
@@ -0,0 +1,596 @@
+//===--- SwitchFormation.cpp - Form switches from comparison chains -------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// After inlining, a 'switch' over an integer, or an if/else-if ladder which
+// compares the same value against a series of constants, is a chain of blocks
+// that each test one constant and branch either to a case body or to the next
+// test:
+//
+//   bb0:
+//     %c0 = builtin "cmp_eq_Int64"(%x, %lit0)
+//     cond_br %c0, bb_case0, bb1
+//   bb1:
+//     %c1 = builtin "cmp_eq_Int64"(%x, %lit1)
+//     cond_br %c1, bb_case1, bb2
+//   ...
+//
+// This pass collapses such a chain into a single switch_value (or, for chains
+// of single-bit select_enums, a single switch_enum), which IRGen lowers to an
+// LLVM switch.  LLVM then picks a jump table, a bit test or a balanced
+// compare tree depending on the density of the cases, instead of evaluating
+// the tests one after another.
+//
+// Small closed ranges ('lo <= x && x <= hi') are expanded into one case per
+// value.  Finally, a switch_value whose destinations only pass integer
+// constants to a common successor is turned into a select_value, which IRGen
+// can emit as a load from a constant table.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "switch-formation"
+
+#include "swift/SILAnalysis/Analysis.h"
+#include "swift/SILPasses/Passes.h"
+#include "swift/SILPasses/Transforms.h"
+#include "swift/SILPasses/Utils/Local.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILInstruction.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumSwitchValueFormed, "Number of switch_value instructions formed");
+STATISTIC(NumSwitchEnumFormed, "Number of switch_enum instructions formed");
+STATISTIC(NumSelectValueFormed, "Number of select_value instructions formed");
+STATISTIC(NumChainBlocksRemoved, "Number of comparison blocks removed");
+
+llvm::cl::opt<unsigned> SwitchFormationMinCases(
+    "sil-switch-formation-min-cases", llvm::cl::init(3),
+    llvm::cl::desc("The minimum number of distinct values a chain of "
+                   "comparisons must test to be turned into a switch"));
+
+/// The largest closed range which is expanded into one case per value.
+static const unsigned MaxRangeCases = 16;
+
+namespace {
+
+/// One test in a chain of comparisons against the same subject.
+struct ChainLink {
+  /// The blocks which make up the test. There are two for a range check.
+  SmallVector<SILBasicBlock *, 2> Blocks;
+
+  /// For integer chains, the values for which the test branches to Target.
+  SmallVector<APInt, 2> Values;
+
+  /// For enum chains, the elements for which the test branches to Target.
+  SmallVector<EnumElementDecl *, 2> Elements;
+
+  /// The subject of the test.
+  SILValue Subject;
+
+  /// Where control goes if the subject matches.
+  SILBasicBlock *Target = nullptr;
+
+  /// Where control goes if it doesn't; the start of the next link, if any.
+  SILBasicBlock *Next = nullptr;
+
+  bool isEnumTest() const { return !Elements.empty(); }
+};
+
+} // end anonymous namespace
+
+/// Return true if \p A and \p B are the same value, or extract the same
+/// field from the same struct (for example the '_value' of an Int which is
+/// re-extracted in every block of the chain).
+static bool isSameSubject(SILValue A, SILValue B) {
+  if (A == B)
+    return true;
+  auto *SA = dyn_cast<StructExtractInst>(A);
+  auto *SB = dyn_cast<StructExtractInst>(B);
+  return SA && SB && SA->getOperand() == SB->getOperand() &&
+         SA->getField() == SB->getField();
+}
+
+/// Return the predicate which gives the same result as \p Kind with the
+/// operands swapped.
+static BuiltinValueKind swapPredicate(BuiltinValueKind Kind) {
+  switch (Kind) {
+  case BuiltinValueKind::ICMP_SLE: return BuiltinValueKind::ICMP_SGE;
+  case BuiltinValueKind::ICMP_SLT: return BuiltinValueKind::ICMP_SGT;
+  case BuiltinValueKind::ICMP_SGE: return BuiltinValueKind::ICMP_SLE;
+  case BuiltinValueKind::ICMP_SGT: return BuiltinValueKind::ICMP_SLT;
+  case BuiltinValueKind::ICMP_ULE: return BuiltinValueKind::ICMP_UGE;
+  case BuiltinValueKind::ICMP_ULT: return BuiltinValueKind::ICMP_UGT;
+  case BuiltinValueKind::ICMP_UGE: return BuiltinValueKind::ICMP_ULE;
+  case BuiltinValueKind::ICMP_UGT: return BuiltinValueKind::ICMP_ULT;
+  default: return Kind;
+  }
+}
+
+/// Match 'builtin "cmp_<pred>"(x, literal)', or the same with the operands
+/// swapped, in which case the predicate is swapped to put x on the left.
+static bool matchIntegerCompare(SILValue Cond, BuiltinValueKind &Kind,
+                                SILValue &Subject, APInt &Value) {
+  auto *BI = dyn_cast<BuiltinInst>(Cond);
+  if (!BI || BI->getNumArguments() != 2)
+    return false;
+
+  Kind = BI->getBuiltinInfo().ID;
+  switch (Kind) {
+  case BuiltinValueKind::ICMP_EQ:
+  case BuiltinValueKind::ICMP_NE:
+  case BuiltinValueKind::ICMP_SLE:
+  case BuiltinValueKind::ICMP_SLT:
+  case BuiltinValueKind::ICMP_SGE:
+  case BuiltinValueKind::ICMP_SGT:
+  case BuiltinValueKind::ICMP_ULE:
+  case BuiltinValueKind::ICMP_ULT:
+  case BuiltinValueKind::ICMP_UGE:
+  case BuiltinValueKind::ICMP_UGT:
+    break;
+  default:
+    return false;
+  }
+
+  OperandValueArrayRef Args = BI->getArguments();
+  if (auto *IL = dyn_cast<IntegerLiteralInst>(Args[1])) {
+    Subject = Args[0];
+    Value = IL->getValue();
+  } else if (auto *IL = dyn_cast<IntegerLiteralInst>(Args[0])) {
+    Subject = Args[1];
+    Value = IL->getValue();
+    Kind = swapPredicate(Kind);
+  } else {
+    return false;
+  }
+
+  // Vectors and raw pointers can't be switched over, and a chain of tests
+  // on a single bit is already as good as it gets.
+  auto IntTy = Subject.getType().getAs<BuiltinIntegerType>();
+  if (!IntTy || !IntTy->isFixedWidth() || IntTy->getFixedWidth() <= 1 ||
+      IntTy->getFixedWidth() > 64)
+    return false;
+  Value = Value.sextOrTrunc(IntTy->getFixedWidth());
+  return true;
+}
+
+/// Turn 'x <pred> Value' into the inclusive bound it establishes if it is
+/// true. Returns false if the comparison is not an ordering, or if the bound
+/// is empty.
+static bool getBound(BuiltinValueKind Kind, APInt Value, bool &IsSigned,
+                     bool &IsLower, APInt &Bound) {
+  switch (Kind) {
+  case BuiltinValueKind::ICMP_SGE:
+  case BuiltinValueKind::ICMP_SGT:
+    IsSigned = true;
+    IsLower = true;
+    if (Kind == BuiltinValueKind::ICMP_SGT) {
+      if (Value.isMaxSignedValue())
+        return false;
+      ++Value;
+    }
+    break;
+  case BuiltinValueKind::ICMP_SLE:
+  case BuiltinValueKind::ICMP_SLT:
+    IsSigned = true;
+    IsLower = false;
+    if (Kind == BuiltinValueKind::ICMP_SLT) {
+      if (Value.isMinSignedValue())
+        return false;
+      --Value;
+    }
+    break;
+  case BuiltinValueKind::ICMP_UGE:
+  case BuiltinValueKind::ICMP_UGT:
+    IsSigned = false;
+    IsLower = true;
+    if (Kind == BuiltinValueKind::ICMP_UGT) {
+      if (Value.isMaxValue())
+        return false;
+      ++Value;
+    }
+    break;
+  case BuiltinValueKind::ICMP_ULE:
+  case BuiltinValueKind::ICMP_ULT:
+    IsSigned = false;
+    IsLower = false;
+    if (Kind == BuiltinValueKind::ICMP_ULT) {
+      if (Value.isMinValue())
+        return false;
+      --Value;
+    }
+    break;
+  default:
+    return false;
+  }
+  Bound = Value;
+  return true;
+}
+
+/// Match a select_enum which yields Builtin.Int1 literals, and return the
+/// elements for which it yields \p Polarity.
+static bool matchEnumTest(SILValue Cond, SILValue &Subject,
+                          SmallVectorImpl<EnumElementDecl *> &Elements,
+                          bool &Polarity) {
+  auto *SEI = dyn_cast<SelectEnumInst>(Cond);
+  if (!SEI)
+    return false;
+
+  // With a default of true, list the elements which yield false instead, so
+  // that the default of the switch is the default of the select.
+  Polarity = true;
+  if (SEI->hasDefault()) {
+    auto *DefaultLit = dyn_cast<IntegerLiteralInst>(SEI->getDefaultResult());
+    if (!DefaultLit)
+      return false;
+    Polarity = DefaultLit->getValue() == 0;
+  }
+
+  for (unsigned i = 0, e = SEI->getNumCases(); i < e; ++i) {
+    auto Case = SEI->getCase(i);
+    auto *Lit = dyn_cast<IntegerLiteralInst>(Case.second);
+    if (!Lit)
+      return false;
+    if ((Lit->getValue() != 0) == Polarity)
+      Elements.push_back(Case.first);
+  }
+  Subject = SEI->getEnumOperand();
+  return !Elements.empty();
+}
+
+/// Return true if every instruction in \p BB other than the terminator is
+/// only used within \p BB, so that the block can be deleted once nothing
+/// branches to it any more.
+static bool isSelfContainedTest(SILBasicBlock *BB) {
+  if (!BB->bbarg_empty())
+    return false;
+  for (auto &I : *BB) {
+    if (isa<TermInst>(&I))
+      continue;
+    if (!isa<IntegerLiteralInst>(&I) && !isa<BuiltinInst>(&I) &&
+        !isa<SelectEnumInst>(&I) && !isa<StructExtractInst>(&I))
+      return false;
+    if (I.mayHaveSideEffects())
+      return false;
+    for (auto *Use : I.getUses())
+      if (Use->getUser()->getParent() != BB)
+        return false;
+  }
+  return true;
+}
+
+/// Return the conditional branch which ends \p BB if it can be part of a
+/// chain. Unless \p IsHead, \p BB must be removable once the chain has been
+/// turned into a switch.
+static CondBranchInst *getChainBranch(SILBasicBlock *BB, bool IsHead) {
+  auto *CBI = dyn_cast<CondBranchInst>(BB->getTerminator());
+  if (!CBI || !CBI->getTrueArgs().empty() || !CBI->getFalseArgs().empty())
+    return nullptr;
+  if (CBI->getTrueBB() == CBI->getFalseBB())
+    return nullptr;
+  if (!IsHead && !isSelfContainedTest(BB))
+    return nullptr;
+  return CBI;
+}
+
+/// Try to match a range check which starts at \p BB with the first bound
+/// already known, and complete \p Link with the values it accepts.
+static bool matchRange(SILBasicBlock *BB, CondBranchInst *CBI,
+                       BuiltinValueKind Kind, const APInt &Value,
+                       ChainLink &Link) {
+  bool IsSigned, IsLower;
+  APInt First;
+  if (!getBound(Kind, Value, IsSigned, IsLower, First))
+    return false;
+
+  // The other bound is checked in the true successor, and a failure of
+  // either check goes to the same place.
+  SILBasicBlock *SecondBB = CBI->getTrueBB();
+  if (SecondBB->getSinglePredecessor() != BB)
+    return false;
+  auto *SecondCBI = getChainBranch(SecondBB, /*IsHead*/ false);
+  if (!SecondCBI || SecondCBI->getFalseBB() != CBI->getFalseBB())
+    return false;
+
+  BuiltinValueKind SecondKind;
+  SILValue SecondSubject;
+  APInt SecondValue;
+  if (!matchIntegerCompare(SecondCBI->getCondition(), SecondKind,
+                           SecondSubject, SecondValue) ||
+      !isSameSubject(SecondSubject, Link.Subject))
+    return false;
+
+  bool SecondIsSigned, SecondIsLower;
+  APInt Second;
+  if (!getBound(SecondKind, SecondValue, SecondIsSigned, SecondIsLower,
+                Second) ||
+      SecondIsSigned != IsSigned || SecondIsLower == IsLower)
+    return false;
+
+  APInt Lo = IsLower ? First : Second;
+  APInt Hi = IsLower ? Second : First;
+  if (IsSigned ? Lo.sgt(Hi) : Lo.ugt(Hi))
+    return false;
+  if ((Hi - Lo).uge(MaxRangeCases))
+    return false;
+
+  for (APInt V = Lo; ; ++V) {
+    Link.Values.push_back(V);
+    if (V == Hi)
+      break;
+  }
+  Link.Blocks.push_back(BB);
+  Link.Blocks.push_back(SecondBB);
+  Link.Target = SecondCBI->getTrueBB();
+  Link.Next = CBI->getFalseBB();
+  return true;
+}
+
+/// Match the test which starts at \p BB.
+static bool matchLink(SILBasicBlock *BB, bool IsHead, ChainLink &Link) {
+  auto *CBI = getChainBranch(BB, IsHead);
+  if (!CBI)
+    return false;
+
+  SILValue Cond = CBI->getCondition();
+  bool Polarity;
+  if (matchEnumTest(Cond, Link.Subject, Link.Elements, Polarity)) {
+    Link.Blocks.push_back(BB);
+    Link.Target = Polarity ? CBI->getTrueBB() : CBI->getFalseBB();
+    Link.Next = Polarity ? CBI->getFalseBB() : CBI->getTrueBB();
+    return true;
+  }
+
+  BuiltinValueKind Kind;
+  APInt Value;
+  if (!matchIntegerCompare(Cond, Kind, Link.Subject, Value))
+    return false;
+
+  switch (Kind) {
+  case BuiltinValueKind::ICMP_EQ:
+  case BuiltinValueKind::ICMP_NE:
+    Link.Values.push_back(Value);
+    Link.Blocks.push_back(BB);
+    if (Kind == BuiltinValueKind::ICMP_EQ) {
+      Link.Target = CBI->getTrueBB();
+      Link.Next = CBI->getFalseBB();
+    } else {
+      Link.Target = CBI->getFalseBB();
+      Link.Next = CBI->getTrueBB();
+    }
+    return true;
+  default:
+    return matchRange(BB, CBI, Kind, Value, Link);
+  }
+}
+
+/// Return true if every predecessor of \p BB is one of \p Blocks.
+static bool isOnlyReachedFrom(SILBasicBlock *BB,
+                              ArrayRef<SILBasicBlock *> Blocks) {
+  if (BB->pred_empty())
+    return false;
+  for (auto *Pred : BB->getPreds())
+    if (std::find(Blocks.begin(), Blocks.end(), Pred) == Blocks.end())
+      return false;
+  return true;
+}
+
+/// Collect the longest chain of tests of the same subject starting at
+/// \p Head.
+static void collectChain(SILBasicBlock *Head,
+                         SmallVectorImpl<ChainLink> &Chain) {
+  ChainLink First;
+  if (!matchLink(Head, /*IsHead*/ true, First))
+    return;
+  Chain.push_back(First);
+
+  llvm::SmallPtrSet<SILBasicBlock *, 16> Visited;
+  Visited.insert(First.Blocks.begin(), First.Blocks.end());
+
+  while (true) {
+    const ChainLink &Prev = Chain.back();
+    SILBasicBlock *BB = Prev.Next;
+    if (Visited.count(BB) || !isOnlyReachedFrom(BB, Prev.Blocks))
+      break;
+
+    ChainLink Link;
+    if (!matchLink(BB, /*IsHead*/ false, Link) ||
+        Link.isEnumTest() != First.isEnumTest() ||
+        !isSameSubject(Link.Subject, First.Subject))
+      break;
+
+    // Every block of the chain but the head has a single predecessor in the
+    // chain, so no test can branch into the middle of it.
+    Visited.insert(Link.Blocks.begin(), Link.Blocks.end());
+    Chain.push_back(Link);
+  }
+}
+
+/// Replace the chain starting at \p Head with a switch_value or switch_enum.
+/// Returns true if the chain was long enough to be worth it.
+static bool formSwitch(SILBasicBlock *Head, ArrayRef<ChainLink> Chain) {
+  auto *CBI = cast<CondBranchInst>(Head->getTerminator());
+  SILValue Subject = Chain.front().Subject;
+  SILBasicBlock *DefaultBB = Chain.back().Next;
+  SILLocation Loc = CBI->getLoc();
+  SILBuilderWithScope B(CBI);
+
+  if (Chain.front().isEnumTest()) {
+    llvm::SmallPtrSet<EnumElementDecl *, 16> Seen;
+    SmallVector<std::pair<EnumElementDecl *, SILBasicBlock *>, 16> Cases;
+    for (auto &Link : Chain)
+      for (auto *Elt : Link.Elements)
+        if (Seen.insert(Elt).second)
+          Cases.push_back({Elt, Link.Target});
+    if (Cases.size() < SwitchFormationMinCases)
+      return false;
+
+    // If every element is covered, the last test's "else" is unreachable
+    // and must not become the default.
+    EnumDecl *E = Subject.getType().getEnumOrBoundGenericEnum();
+    bool Exhaustive = E && Cases.size() == E->getAllElements().size();
+    B.createSwitchEnum(Loc, Subject, Exhaustive ? nullptr : DefaultBB, Cases);
+    ++NumSwitchEnumFormed;
+  } else {
+    llvm::SmallSet<uint64_t, 16> Seen;
+    SmallVector<std::pair<APInt, SILBasicBlock *>, 16> Values;
+    for (auto &Link : Chain)
+      for (auto &V : Link.Values)
+        if (Seen.insert(V.getZExtValue()).second)
+          Values.push_back({V, Link.Target});
+    if (Values.size() < SwitchFormationMinCases)
+      return false;
+
+    SILType Ty = Subject.getType();
+    SmallVector<std::pair<SILValue, SILBasicBlock *>, 16> Cases;
+    for (auto &V : Values)
+      Cases.push_back({B.createIntegerLiteral(Loc, Ty, V.first), V.second});
+    B.createSwitchValue(Loc, Subject, DefaultBB, Cases);
+    ++NumSwitchValueFormed;
+  }
+
+  DEBUG(llvm::dbgs() << "SwitchFormation: collapsed " << Chain.size()
+                     << " tests in " << Head->getParent()->getName() << "\n");
+
+  SILValue Cond = CBI->getCondition();
+  CBI->eraseFromParent();
+  if (auto *CondInst = dyn_cast<SILInstruction>(Cond))
+    recursivelyDeleteTriviallyDeadInstructions(CondInst);
+
+  // The first block of each link is now unreachable, which in turn makes
+  // the rest of the link unreachable.
+  for (auto &Link : Chain)
+    for (auto *BB : Link.Blocks) {
+      if (BB == Head)
+        continue;
+      removeDeadBlock(BB);
+      ++NumChainBlocksRemoved;
+    }
+  return true;
+}
+
+/// Turn a switch_value whose destinations do nothing but pass an integer
+/// literal to the same successor into a select_value of the literals.
+static bool formSelectValue(SwitchValueInst *SVI) {
+  if (!SVI->hasDefault())
+    return false;
+
+  SILBasicBlock *MergeBB = nullptr;
+  auto getResult = [&](SILBasicBlock *Dest) -> IntegerLiteralInst * {
+    if (Dest->getSinglePredecessor() != SVI->getParent() ||
+        !Dest->bbarg_empty())
+      return nullptr;
+    auto *Br = dyn_cast<BranchInst>(Dest->getTerminator());
+    if (!Br || Br->getNumArgs() != 1)
+      return nullptr;
+    if (MergeBB && Br->getDestBB() != MergeBB)
+      return nullptr;
+    auto *Result = dyn_cast<IntegerLiteralInst>(Br->getArg(0));
+    if (!Result)
+      return nullptr;
+
+    // Besides the branch, the block may only contain the literal it passes,
+    // and only if the branch is the literal's one use.
+    for (auto &I : *Dest)
+      if (&I != Br && &I != Result)
+        return nullptr;
+    if (Result->getParent() == Dest && !Result->hasOneUse())
+      return nullptr;
+
+    MergeBB = Br->getDestBB();
+    return Result;
+  };
+
+  SmallVector<std::pair<SILValue, SILValue>, 16> CaseResults;
+  for (unsigned i = 0, e = SVI->getNumCases(); i < e; ++i) {
+    auto Case = SVI->getCase(i);
+    auto *Result = getResult(Case.second);
+    if (!Result)
+      return false;
+    CaseResults.push_back({Case.first, Result});
+  }
+  auto *DefaultResult = getResult(SVI->getDefaultBB());
+  if (!DefaultResult || MergeBB->getNumBBArg() != 1)
+    return false;
+
+  // The select's operands must dominate it. A literal may be defined in the
+  // destination block that passes it, which does not dominate the switch and
+  // is about to be removed, so recreate every literal in front of the select.
+  SILBuilderWithScope B(SVI);
+  SILLocation Loc = SVI->getLoc();
+  auto cloneLiteral = [&](SILValue V) -> SILValue {
+    auto *IL = cast<IntegerLiteralInst>(V);
+    return B.createIntegerLiteral(IL->getLoc(), IL->getType(), IL->getValue());
+  };
+  for (auto &CR : CaseResults)
+    CR.second = cloneLiteral(CR.second);
+  SILValue Default = cloneLiteral(DefaultResult);
+
+  SILType ResultTy = MergeBB->getBBArg(0)->getType();
+  auto *Select = B.createSelectValue(Loc, SVI->getOperand(), ResultTy,
+                                     Default, CaseResults);
+  B.createBranch(Loc, MergeBB, SILValue(Select));
+
+  llvm::SmallPtrSet<SILBasicBlock *, 16> Dests;
+  for (unsigned i = 0, e = SVI->getNumCases(); i < e; ++i)
+    Dests.insert(SVI->getCase(i).second);
+  Dests.insert(SVI->getDefaultBB());
+  SVI->eraseFromParent();
+  for (auto *BB : Dests)
+    removeDeadBlock(BB);
+
+  ++NumSelectValueFormed;
+  return true;
+}
+
+namespace {
+
+/// Collapse chains of comparisons of one value against constants into
+/// switch_value and switch_enum instructions.
+class SwitchFormation : public SILFunctionTransform {
+public:
+  SwitchFormation() {}
+
+  StringRef getName() override { return "Switch Formation"; }
+
+  void run() override {
+    SILFunction *F = getFunction();
+    bool Changed = false;
+
+    // Forming a switch only removes blocks other than the chain's head, so
+    // the iterator stays valid.
+    for (auto It = F->begin(); It != F->end(); ++It) {
+      SmallVector<ChainLink, 8> Chain;
+      collectChain(&*It, Chain);
+      if (!Chain.empty() && formSwitch(&*It, Chain))
+        Changed = true;
+    }
+
+    for (auto &BB : *F)
+      if (auto *SVI = dyn_cast<SwitchValueInst>(BB.getTerminator()))
+        Changed |= formSelectValue(SVI);
+
+    if (Changed)
+      PM->invalidateAnalysis(F, SILAnalysis::InvalidationKind::FunctionBody);
+  }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createSwitchFormation() {
+  return new SwitchFormation();
+}
@@ -15,11 +15,24 @@
 //===----------------------------------------------------------------------===//
 
 #include "ConstraintSystem.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/SaveAndRestore.h"
+#include "llvm/Support/Timer.h"
 
 using namespace swift;
 using namespace constraints;
 
+#define DEBUG_TYPE "Constraint diagnosis"
+STATISTIC(NumDiagnosedExprs,
+          "# of expressions diagnosed after failing to type-check");
+STATISTIC(NumSubExprRechecks,
+          "# of sub-expressions re-type-checked during diagnosis");
+STATISTIC(NumMemoizedRecheckFailures,
+          "# of sub-expression re-type-checks skipped as known failures");
+STATISTIC(NumDiagnosisBudgetsExceeded,
+          "# of diagnoses abandoned after too many re-type-checks");
+
 static bool isUnresolvedOrTypeVarType(Type ty) {
   return ty->is<TypeVariableType>() || ty->is<UnresolvedType>();
 }
@@ -2709,6 +2722,17 @@ typeCheckChildIndependently(Expr *subExpr, Type convertType,
   
     CS->TC.addExprForDiagnosis(subExpr, subExpr);
   }
+
+  // Stop re-type-checking once this diagnosis has done too much work.  The
+  // outermost diagnoseFailureForExpr reports the expression as too complex.
+  auto &diagnosisState = CS->TC.ExprDiagnosis;
+  if (diagnosisState.BudgetExceeded)
+    return nullptr;
+  if (diagnosisState.NumRechecks >= CS->TC.getLangOpts().DiagnosisRecheckLimit) {
+    diagnosisState.BudgetExceeded = true;
+    ++NumDiagnosisBudgetsExceeded;
+    return nullptr;
+  }
   
   // If we have a conversion type, but it has type variables (from the current
   // ConstraintSystem), then we can't use it.
@@ -2741,6 +2765,21 @@ typeCheckChildIndependently(Expr *subExpr, Type convertType,
        isa<OverloadedMemberRefExpr>(subExpr->getValueProvidingExpr()))) {
     return subExpr;
   }
+
+  // If exactly this re-type-check already failed during this diagnosis, its
+  // errors have been emitted; don't solve it again.  A listener may change
+  // the result, so those checks are always repeated.
+  auto recheckKey = std::make_pair(subExpr,
+    std::make_pair(convertType.getPointer(),
+                   unsigned(convertTypePurpose) << 8 | options.toRaw()));
+  bool memoize =
+    !listener && !CS->TC.getLangOpts().DisableDiagnosisMemoization;
+  if (memoize && diagnosisState.FailedRechecks.count(recheckKey)) {
+    ++NumMemoizedRecheckFailures;
+    return nullptr;
+  }
+  ++diagnosisState.NumRechecks;
+  ++NumSubExprRechecks;
   
   ExprTypeSaver SavedTypeData;
   SavedTypeData.save(subExpr);
@@ -2782,8 +2821,11 @@ typeCheckChildIndependently(Expr *subExpr, Type convertType,
   
   // If recursive type checking failed, then an error was emitted.  Return
   // null to indicate this to the caller.
-  if (hadError)
+  if (hadError) {
+    if (memoize)
+      diagnosisState.FailedRechecks.insert(recheckKey);
     return nullptr;
+  }
 
   // If we type checked the result but failed to get a usable output from it,
   // just pretend as though nothing happened.
@@ -4705,6 +4747,52 @@ bool FailureDiagnosis::diagnoseExprFailure() {
 /// This is guaranteed to always emit an error message.
 ///
 void ConstraintSystem::diagnoseFailureForExpr(Expr *expr) {
+  // Diagnosing a sub-expression re-type-checks it, which can fail and diagnose
+  // its own sub-expressions in turn.  All of these nested diagnoses share one
+  // budget of re-type-checks, set up by the outermost one.
+  auto &state = TC.ExprDiagnosis;
+  if (state.Depth > 0) {
+    ++state.Depth;
+    diagnoseFailureForExprWithinBudget(expr);
+    --state.Depth;
+    return;
+  }
+
+  ++NumDiagnosedExprs;
+  state.Depth = 1;
+  state.NumRechecks = 0;
+  state.BudgetExceeded = false;
+  state.FailedRechecks.clear();
+  llvm::TimeRecord startTime = llvm::TimeRecord::getCurrentTime();
+
+  diagnoseFailureForExprWithinBudget(expr);
+
+  state.Depth = 0;
+  state.FailedRechecks.clear();
+
+  // If the budget ran out, the diagnosis may have stopped before emitting
+  // anything useful.
+  if (state.BudgetExceeded) {
+    TC.diagnose(expr->getLoc(), diag::expression_too_complex)
+      .highlight(expr->getSourceRange());
+  }
+
+  if (TC.getDebugTimeExpressionDiagnosis()) {
+    llvm::TimeRecord endTime = llvm::TimeRecord::getCurrentTime(false);
+    auto elapsed = endTime.getProcessTime() - startTime.getProcessTime();
+    llvm::errs() << llvm::format("%0.1f", elapsed * 1000) << "ms\t";
+    expr->getLoc().print(llvm::errs(), TC.Context.SourceMgr);
+    llvm::errs() << "\t" << state.NumRechecks << " re-type-checks";
+    if (state.BudgetExceeded)
+      llvm::errs() << " (budget exceeded)";
+    llvm::errs() << "\n";
+  }
+
+  state.NumRechecks = 0;
+  state.BudgetExceeded = false;
+}
+
+void ConstraintSystem::diagnoseFailureForExprWithinBudget(Expr *expr) {
   // Continue simplifying any active constraints left in the system.  We can end
   // up with them because the solver bails out as soon as it sees a Failure.  We
   // don't want to leave them around in the system because later diagnostics
@@ -26,6 +26,9 @@ using namespace constraints;
 //===--------------------------------------------------------------------===//
 #define DEBUG_TYPE "Constraint solver overall"
 STATISTIC(NumDiscardedSolutions, "# of solutions discarded");
+STATISTIC(NumSolutionComparisons, "# of pairs of solutions compared");
+STATISTIC(NumCachedSpecializationComparisons,
+          "# of declaration specialization comparisons reused");
 
 void ConstraintSystem::increaseScore(ScoreKind kind) {
   unsigned index = static_cast<unsigned>(kind);
@@ -724,11 +727,29 @@ Comparison TypeChecker::compareDeclarations(DeclContext *dc,
   return decl1Better? Comparison::Better : Comparison::Worse;
 }
 
+/// \brief Determine whether the first declaration is as "specialized" as
+/// the second declaration, reusing the answer from an earlier comparison in
+/// the same constraint system if there was one.
+static bool isDeclAsSpecializedAs(ConstraintSystem &cs,
+                                  ValueDecl *decl1, ValueDecl *decl2) {
+  auto known = cs.DeclSpecializationCache.find({decl1, decl2});
+  if (known != cs.DeclSpecializationCache.end()) {
+    ++NumCachedSpecializationComparisons;
+    return known->second;
+  }
+
+  bool result = isDeclAsSpecializedAs(cs.getTypeChecker(), cs.DC, decl1, decl2);
+  cs.DeclSpecializationCache[{decl1, decl2}] = result;
+  return result;
+}
+
 SolutionCompareResult
 ConstraintSystem::compareSolutions(ConstraintSystem &cs,
                                    ArrayRef<Solution> solutions,
                                    const SolutionDiff &diff,
                                    unsigned idx1, unsigned idx2) {
+  ++NumSolutionComparisons;
+
   // Whether the solutions are identical.
   bool identical = true;
 
@@ -840,11 +861,11 @@ ConstraintSystem::compareSolutions(ConstraintSystem &cs,
     // Determine whether one declaration is more specialized than the other.
     bool firstAsSpecializedAs = false;
     bool secondAsSpecializedAs = false;
-    if (isDeclAsSpecializedAs(tc, cs.DC, decl1, decl2)) {
+    if (isDeclAsSpecializedAs(cs, decl1, decl2)) {
       ++score1;
       firstAsSpecializedAs = true;
     }
-    if (isDeclAsSpecializedAs(tc, cs.DC, decl2, decl1)) {
+    if (isDeclAsSpecializedAs(cs, decl2, decl1)) {
       ++score2;
       secondAsSpecializedAs = true;
     }
@@ -1141,10 +1162,26 @@ ConstraintSystem::findBestSolution(SmallVectorImpl<Solution> &viable,
 
   SolutionDiff diff(viable);
 
-  // Find a potential best.
+  // The fixed scores are compared before anything else, so every solution
+  // whose fixed score is worse than the best one loses to every solution that
+  // has the best fixed score.  Only the latter need to be compared in detail.
   SmallVector<bool, 16> losers(viable.size(), false);
-  unsigned bestIdx = 0;
+  Score bestFixedScore = viable[0].getFixedScore();
   for (unsigned i = 1, n = viable.size(); i != n; ++i) {
+    if (viable[i].getFixedScore() < bestFixedScore)
+      bestFixedScore = viable[i].getFixedScore();
+  }
+  SmallVector<unsigned, 16> candidates;
+  for (unsigned i = 0, n = viable.size(); i != n; ++i) {
+    if (viable[i].getFixedScore() == bestFixedScore)
+      candidates.push_back(i);
+    else
+      losers[i] = true;
+  }
+
+  // Find a potential best.
+  unsigned bestIdx = candidates[0];
+  for (unsigned i : makeArrayRef(candidates).slice(1)) {
     switch (compareSolutions(*this, viable, diff, i, bestIdx)) {
     case SolutionCompareResult::Identical:
       // FIXME: Might want to warn about this in debug builds, so we can
@@ -1165,7 +1202,9 @@ ConstraintSystem::findBestSolution(SmallVectorImpl<Solution> &viable,
 
   // Make sure that our current best is better than all of the solved systems.
   bool ambiguous = false;
-  for (unsigned i = 0, n = viable.size(); i != n && !ambiguous; ++i) {
+  for (unsigned i : candidates) {
+    if (ambiguous)
+      break;
     if (i == bestIdx)
       continue;
 
@@ -1201,13 +1240,17 @@ ConstraintSystem::findBestSolution(SmallVectorImpl<Solution> &viable,
 
   // The comparison was ambiguous. Identify any solutions that are worse than
   // any other solution.
-  for (unsigned i = 0, n = viable.size(); i != n; ++i) {
+  for (unsigned ci = 0, n = candidates.size(); ci != n; ++ci) {
+    unsigned i = candidates[ci];
+
     // If the first solution has already lost once, don't bother looking
     // further.
     if (losers[i])
       continue;
 
-    for (unsigned j = i + 1; j != n; ++j) {
+    for (unsigned cj = ci + 1; cj != n; ++cj) {
+      unsigned j = candidates[cj];
+
       // If the second solution has already lost once, don't bother looking
       // further.
       if (losers[j])
@@ -1246,8 +1289,8 @@ ConstraintSystem::findBestSolution(SmallVectorImpl<Solution> &viable,
 
     ++outIndex;
   }
-  viable.erase(viable.begin() + outIndex, viable.end());
   NumDiscardedSolutions += viable.size() - outIndex;
+  viable.erase(viable.begin() + outIndex, viable.end());
 
   return None;
 }
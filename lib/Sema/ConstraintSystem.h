@@ -1316,6 +1316,14 @@ public:
   /// that locator.
   llvm::DenseMap<ConstraintLocator *, ArrayRef<Identifier>> ArgumentLabels;
 
+  /// Whether the first declaration is as specialized as the second, for the
+  /// pairs of overload choices compared while ranking solutions.  Answering
+  /// this can require solving another constraint system, and the same pairs
+  /// come up again and again when many solutions choose among the same
+  /// overloads.
+  llvm::DenseMap<std::pair<ValueDecl *, ValueDecl *>, bool>
+    DeclSpecializationCache;
+
   /// FIXME: This is a workaround for the way we perform protocol
   /// conformance checking for generic requirements, where we re-use
   /// the archetypes of the requirement (rather than, say, building
@@ -1681,6 +1689,10 @@ public:
   /// emits an error message.
   void diagnoseFailureForExpr(Expr *expr);
 
+  /// Produce a specific diagnostic for the failure of \p expr; the body of
+  /// diagnoseFailureForExpr, which keeps track of the diagnosis budget.
+  void diagnoseFailureForExprWithinBudget(Expr *expr);
+
   /// \brief Add a newly-allocated constraint after attempting to simplify
   /// it.
   ///
@@ -21,8 +21,19 @@
 #include "swift/AST/Decl.h"
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/Basic/Defer.h"
+#include "llvm/ADT/Statistic.h"
 using namespace swift;
 
+#define DEBUG_TYPE "Iterative type checker"
+STATISTIC(NumRequestsSatisfied, "# of type check requests satisfied");
+STATISTIC(NumCachedSatisfiedRequests,
+          "# of type check requests found already satisfied in the cache");
+STATISTIC(NumCircularReferences, "# of circular references diagnosed");
+#define TYPE_CHECK_REQUEST(Request,PayloadName)                   \
+STATISTIC(Num##Request##Processed,                                \
+          "# of " #Request " requests processed");
+#include "swift/Sema/TypeCheckRequestKinds.def"
+
 ASTContext &IterativeTypeChecker::getASTContext() const {
   return TC.Context;
 }
@@ -37,6 +48,7 @@ void IterativeTypeChecker::process(
   switch (request.getKind()) {
 #define TYPE_CHECK_REQUEST(Request,PayloadName)                   \
   case TypeCheckRequest::Request:                                 \
+    ++Num##Request##Processed;                                    \
     return process##Request(request.get##PayloadName##Payload(),  \
                             unsatisfiedDependency);
 
@@ -46,13 +58,29 @@ void IterativeTypeChecker::process(
 
 /// Determine whether the given request has already been satisfied.
 bool IterativeTypeChecker::isSatisfied(TypeCheckRequest request) {
+  // Satisfying a request only adds information to the AST, so a request
+  // that was satisfied once stays satisfied unless the type checker reverts
+  // that information (see TypeChecker::revertGenericParamList).
+  if (TC.SatisfiedTypeCheckRequests.count(request)) {
+    ++NumCachedSatisfiedRequests;
+    return true;
+  }
+
+  bool satisfied;
   switch (request.getKind()) {
-#define TYPE_CHECK_REQUEST(Request,PayloadName)                         \
-  case TypeCheckRequest::Request:                                       \
-    return is##Request##Satisfied(request.get##PayloadName##Payload());
+#define TYPE_CHECK_REQUEST(Request,PayloadName)                               \
+  case TypeCheckRequest::Request:                                             \
+    satisfied = is##Request##Satisfied(request.get##PayloadName##Payload());  \
+    break;
 
 #include "swift/Sema/TypeCheckRequestKinds.def"
   }
+
+  // Type resolution is satisfied by the bindings within a TypeRepr rather
+  // than by declarations, so don't cache it.
+  if (satisfied && request.getKind() != TypeCheckRequest::ResolveTypeRepr)
+    TC.SatisfiedTypeCheckRequests.insert(request);
+  return satisfied;
 }
 
 bool IterativeTypeChecker::breakCycle(TypeCheckRequest request) {
@@ -70,13 +98,13 @@ void IterativeTypeChecker::satisfy(TypeCheckRequest request) {
   if (isSatisfied(request)) return;
 
   // Check for circular dependencies in our requests.
-  // FIXME: This stack operation is painfully inefficient.
-  auto existingRequest = std::find(ActiveRequests.rbegin(),
-                                   ActiveRequests.rend(),
-                                   request);
-  if (existingRequest != ActiveRequests.rend()) {
+  if (ActiveRequestSet.count(request)) {
+    auto existingRequest = std::find(ActiveRequests.rbegin(),
+                                     ActiveRequests.rend(),
+                                     request);
     auto first = existingRequest.base();
     --first;
+    ++NumCircularReferences;
     diagnoseCircularReference(llvm::makeArrayRef(&*first,
                                                  &*ActiveRequests.end()));
     return;
@@ -84,7 +112,11 @@ void IterativeTypeChecker::satisfy(TypeCheckRequest request) {
 
   // Add this request to the stack of active requests.
   ActiveRequests.push_back(request);
-  defer { ActiveRequests.pop_back(); };
+  ActiveRequestSet.insert(request);
+  defer {
+    ActiveRequestSet.erase(ActiveRequests.back());
+    ActiveRequests.pop_back();
+  };
 
   while (true) {
     // Process this requirement, enumerating dependencies if anything else needs
@@ -101,9 +133,18 @@ void IterativeTypeChecker::satisfy(TypeCheckRequest request) {
     // If there were no unsatisfied dependencies, we're done.
     if (unsatisfied.empty()) {
       assert(isSatisfied(request));
+      ++NumRequestsSatisfied;
       break;
     }
 
+    // Record the dependencies we haven't seen before.
+    auto &dependencies = TC.TypeCheckRequestDependencies[request];
+    for (auto dependency : unsatisfied) {
+      if (std::find(dependencies.begin(), dependencies.end(), dependency)
+            == dependencies.end())
+        dependencies.push_back(dependency);
+    }
+
     // Recurse to satisfy any unsatisfied dependencies.
     // FIXME: Don't recurse in the iterative type checker, silly!
     for (auto dependency : unsatisfied) {
@@ -112,6 +153,15 @@ void IterativeTypeChecker::satisfy(TypeCheckRequest request) {
   }
 }
 
+ArrayRef<TypeCheckRequest>
+IterativeTypeChecker::getDependencies(TypeCheckRequest request) const {
+  auto known = TC.TypeCheckRequestDependencies.find(request);
+  if (known == TC.TypeCheckRequestDependencies.end())
+    return { };
+
+  return known->second;
+}
+
 //----------------------------------------------------------------------------//
 // Diagnostics
 //----------------------------------------------------------------------------//
@@ -20,6 +20,7 @@
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/AST/ASTWalker.h"
 #include "swift/AST/ModuleLoader.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/ClangImporter/ClangModule.h"
 #include "clang/Basic/Module.h"
 #include "llvm/ADT/DenseMap.h"
@@ -293,10 +294,16 @@ void swift::performNameBinding(SourceFile &SF, unsigned StartElem) {
     return;
   }
 
+  tracing::TracedSpan Span("Name binding", "frontend");
+
   // Reset the name lookup cache so we find new decls.
   // FIXME: This is inefficient.
   SF.clearLookupCache();
 
+  // Lookups cached by the module's other files may not have seen the decls
+  // being bound.
+  SF.getParentModule()->addedTopLevelDecls();
+
   NameBinder Binder(SF);
 
   SmallVector<std::pair<ImportedModule, ImportOptions>, 8> ImportedModules;
@@ -21,6 +21,7 @@
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/Parse/DelayedParsingCallbacks.h"
 #include "swift/Parse/PersistentParserState.h"
+#include "swift/Basic/DirectoryListingCache.h"
 #include "swift/Basic/SourceManager.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -36,11 +37,15 @@ using FileOrError = llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>;
 static FileOrError findModule(ASTContext &ctx, StringRef moduleID,
                               SourceLoc importLoc) {
   llvm::SmallString<128> inputFilename;
+  llvm::SmallString<64> moduleFilename(moduleID);
+  moduleFilename.append(".swift");
 
   for (auto Path : ctx.SearchPathOpts.ImportSearchPaths) {
+    if (!DirectoryListingCache::get().mayContain(Path, moduleFilename.str()))
+      continue;
+
     inputFilename = Path;
-    llvm::sys::path::append(inputFilename, moduleID);
-    inputFilename.append(".swift");
+    llvm::sys::path::append(inputFilename, moduleFilename.str());
     llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileBufOrErr =
       llvm::MemoryBuffer::getFile(inputFilename.str());
 
@@ -768,8 +768,13 @@ void TypeChecker::revertGenericParamList(GenericParamList *genericParams) {
   // Revert the inherited clause of the generic parameter list.
   for (auto param : *genericParams) {
     param->setCheckedInheritanceClause(false);
-    for (auto &inherited : param->getInherited())
-      revertDependentTypeLoc(inherited);
+    for (unsigned i = 0, n = param->getInherited().size(); i != n; ++i) {
+      revertDependentTypeLoc(param->getInherited()[i]);
+
+      // The inherited clause entry has to be resolved again.
+      SatisfiedTypeCheckRequests.erase(
+        requestResolveInheritedClauseEntry({ param, i }));
+    }
   }
 
   // Revert the requirements of the generic parameter list.
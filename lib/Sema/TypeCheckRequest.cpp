@@ -103,3 +103,44 @@ bool swift::operator==(const TypeCheckRequest &x, const TypeCheckRequest &y) {
 #include "swift/Sema/TypeCheckRequestPayloads.def"
   }
 }
+
+llvm::hash_code swift::hash_value(const TypeCheckRequest &request) {
+  // Only hash the parts of the payload that operator== compares.
+  llvm::hash_code payloadHash;
+  switch (TypeCheckRequest::getPayloadKind(request.getKind())) {
+#define HASH_POINTER_PAYLOAD(PayloadName)                                \
+  case TypeCheckRequest::PayloadKind::PayloadName:                       \
+    payloadHash = llvm::hash_value(request.get##PayloadName##Payload()); \
+    break;
+
+  HASH_POINTER_PAYLOAD(Class)
+  HASH_POINTER_PAYLOAD(Enum)
+
+  case TypeCheckRequest::PayloadKind::InheritedClauseEntry: {
+    auto payload = request.getInheritedClauseEntryPayload();
+    payloadHash = llvm::hash_combine(payload.first.getOpaqueValue(),
+                                     payload.second);
+    break;
+  }
+
+  HASH_POINTER_PAYLOAD(Protocol)
+
+  case TypeCheckRequest::PayloadKind::DeclContextLookup:
+    payloadHash = hash_value(request.getDeclContextLookupPayload());
+    break;
+
+  case TypeCheckRequest::PayloadKind::TypeResolution: {
+    auto payload = request.getTypeResolutionPayload();
+    payloadHash = llvm::hash_combine(std::get<0>(payload),
+                                     std::get<1>(payload),
+                                     std::get<2>(payload));
+    break;
+  }
+
+  HASH_POINTER_PAYLOAD(TypeDeclResolution)
+
+#undef HASH_POINTER_PAYLOAD
+  }
+
+  return llvm::hash_combine(unsigned(request.getKind()), payloadHash);
+}
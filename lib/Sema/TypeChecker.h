@@ -453,6 +453,17 @@ public:
   /// This can't use CanTypes because typealiases may have more limited types
   /// than their underlying types.
   llvm::DenseMap<Type, Accessibility> TypeAccessibilityCache;
+
+  /// The type check requests that an IterativeTypeChecker has found to be
+  /// satisfied, so that later iterative type checkers don't check them
+  /// again.  Anything that reverts the information a request computed must
+  /// remove the request from this set.
+  llvm::DenseSet<TypeCheckRequest> SatisfiedTypeCheckRequests;
+
+  /// The unsatisfied dependencies found while processing each type check
+  /// request, in the order in which they were first found.
+  llvm::DenseMap<TypeCheckRequest, SmallVector<TypeCheckRequest, 2>>
+    TypeCheckRequestDependencies;
   
   // We delay validation of C and Objective-C type-bridging functions in the
   // standard library until we encounter a declaration that requires one. This
@@ -526,6 +537,28 @@ private:
   /// The set of expressions currently being analyzed for failures.
   llvm::DenseMap<Expr*, Expr*> DiagnosedExprs;
 
+  /// The state of the diagnosis of an expression that failed to type-check,
+  /// shared by the nested diagnoses of its sub-expressions.
+  struct ExprDiagnosisState {
+    /// The nesting depth of ConstraintSystem::diagnoseFailureForExpr.
+    unsigned Depth = 0;
+
+    /// The number of sub-expressions re-type-checked so far.
+    unsigned NumRechecks = 0;
+
+    /// Set once NumRechecks reaches LangOptions::DiagnosisRecheckLimit; no
+    /// more sub-expressions are re-type-checked after that.
+    bool BudgetExceeded = false;
+
+    /// The sub-expression, contextual type, contextual type purpose and
+    /// TCCOptions of each re-type-check that failed.  These have already
+    /// emitted their diagnostics, so repeating them is pointless.
+    llvm::DenseSet<std::pair<Expr *, std::pair<TypeBase *, unsigned>>>
+      FailedRechecks;
+  };
+
+  ExprDiagnosisState ExprDiagnosis;
+
   /// A set of types that are representable in Objective-C, but require
   /// non-trivial bridging.
   ///
@@ -542,6 +575,10 @@ private:
   /// to llvm::errs().
   bool DebugTimeFunctionBodies = false;
 
+  /// If true, the time it takes to diagnose each expression that fails to
+  /// type-check will be dumped to llvm::errs().
+  bool DebugTimeExpressionDiagnosis = false;
+
   /// Indicate that the type checker is checking code that will be
   /// immediately executed. This will suppress certain warnings
   /// when executing scripts.
@@ -564,6 +601,16 @@ public:
     DebugTimeFunctionBodies = true;
   }
 
+  /// Dump the time it takes to diagnose each expression that fails to
+  /// type-check to llvm::errs().
+  void enableDebugTimeExpressionDiagnosis() {
+    DebugTimeExpressionDiagnosis = true;
+  }
+
+  bool getDebugTimeExpressionDiagnosis() const {
+    return DebugTimeExpressionDiagnosis;
+  }
+
   bool getInImmediateMode() {
     return InImmediateMode;
   }
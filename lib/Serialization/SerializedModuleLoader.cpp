@@ -15,6 +15,7 @@
 #include "swift/Strings.h"
 #include "swift/AST/AST.h"
 #include "swift/AST/DiagnosticsSema.h"
+#include "swift/Basic/DirectoryListingCache.h"
 #include "swift/Basic/STLExtras.h"
 #include "swift/Basic/SourceManager.h"
 #include "llvm/ADT/SmallString.h"
@@ -94,8 +95,15 @@ findModule(ASTContext &ctx, AccessPathElem moduleID,
   llvm::SmallString<128> scratch;
   llvm::SmallString<128> currPath;
 
+  // Skip search paths whose listings show that they don't contain the module,
+  // rather than failing to open files in each of them.
+  auto &listings = DirectoryListingCache::get();
+
   isFramework = false;
   for (auto path : ctx.SearchPathOpts.ImportSearchPaths) {
+    if (!listings.mayContain(path, moduleFilename.str()))
+      continue;
+
     auto err = openModuleFiles(path,
                                moduleFilename.str(), moduleDocFilename.str(),
                                moduleBuffer, moduleDocBuffer,
@@ -118,6 +126,9 @@ findModule(ASTContext &ctx, AccessPathElem moduleID,
     isFramework = true;
 
     for (auto path : ctx.SearchPathOpts.FrameworkSearchPaths) {
+      if (!listings.mayContain(path, moduleFramework.str()))
+        continue;
+
       currPath = path;
       llvm::sys::path::append(currPath, moduleFramework.str(),
                               "Modules", moduleFilename.str());
@@ -136,6 +147,9 @@ findModule(ASTContext &ctx, AccessPathElem moduleID,
 
   // Search the runtime import path.
   isFramework = false;
+  if (!listings.mayContain(ctx.SearchPathOpts.RuntimeLibraryImportPath,
+                           moduleFilename.str()))
+    return std::make_error_code(std::errc::no_such_file_or_directory);
   return openModuleFiles(ctx.SearchPathOpts.RuntimeLibraryImportPath,
                          moduleFilename.str(), moduleDocFilename.str(),
                          moduleBuffer, moduleDocBuffer, scratch);
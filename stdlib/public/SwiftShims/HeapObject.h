@@ -38,6 +38,8 @@ struct HeapObject {
   // FIXME: allocate two words of metadata on 32-bit platforms
 
 #ifdef __cplusplus
+  enum Immortal_t { Immortal };
+
   HeapObject() = default;
 
   // Initialize a HeapObject header as appropriate for a newly-allocated object.
@@ -46,6 +48,14 @@ struct HeapObject {
     , refCount(StrongRefCount::Initialized)
     , weakRefCount(WeakRefCount::Initialized)
   { }
+
+  // Initialize a HeapObject header for a statically-allocated object that is
+  // never deallocated.  Retaining and releasing it does nothing.
+  constexpr HeapObject(HeapMetadata const *newMetadata, Immortal_t)
+    : metadata(newMetadata)
+    , refCount(StrongRefCount::Immortal)
+    , weakRefCount(WeakRefCount::Immortal)
+  { }
 #endif
 };
 
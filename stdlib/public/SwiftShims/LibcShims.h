@@ -36,6 +36,10 @@ void _swift_stdlib_free(void *ptr);
 
 // Input/output <stdio.h>
 int _swift_stdlib_putchar(int c);
+int _swift_stdlib_putchar_unlocked(int c);
+__swift_size_t _swift_stdlib_fwrite_stdout(const void *ptr,
+                                           __swift_size_t size,
+                                           __swift_size_t nitems);
 
 // String handling <string.h>
 __attribute__((pure))
@@ -56,6 +56,12 @@ class StrongRefCount {
   // The next bit is the deallocating marker.
   // The remaining bits are the reference count.
   // refCount == RC_ONE means reference count == 1.
+  //
+  // The top bit of the reference count, which no real count reaches, marks
+  // an immortal object: a statically-allocated object that is never
+  // deallocated.  Increments and decrements of an immortal object's count
+  // do nothing, so that its count stays far from zero and its cache line is
+  // never written.
   enum : uint32_t {
     RC_PINNED_FLAG = 0x1,
     RC_DEALLOCATING_FLAG = 0x2,
@@ -64,7 +70,9 @@ class StrongRefCount {
     RC_FLAGS_MASK = 3,
     RC_COUNT_MASK = ~RC_FLAGS_MASK,
 
-    RC_ONE = RC_FLAGS_MASK + 1
+    RC_ONE = RC_FLAGS_MASK + 1,
+
+    RC_IMMORTAL_FLAG = 0x80000000
   };
 
   static_assert(RC_ONE == RC_DEALLOCATING_FLAG << 1,
@@ -77,6 +85,8 @@ class StrongRefCount {
  public:
   enum Initialized_t { Initialized };
 
+  enum Immortal_t { Immortal };
+
   // StrongRefCount must be trivially constructible to avoid ObjC++
   // destruction overhead at runtime. Use StrongRefCount(Initialized) to produce
   // an initialized instance.
@@ -86,17 +96,25 @@ class StrongRefCount {
   constexpr StrongRefCount(Initialized_t)
     : refCount(RC_ONE) { }
 
+  // Refcount of an immortal object.
+  constexpr StrongRefCount(Immortal_t)
+    : refCount(RC_IMMORTAL_FLAG) { }
+
   void init() {
     refCount = RC_ONE;
   }
 
   // Increment the reference count.
   void increment() {
+    if (isImmortal())
+      return;
     __atomic_fetch_add(&refCount, RC_ONE, __ATOMIC_RELAXED);
   }
 
   // Increment the reference count by n.
   void increment(uint32_t n) {
+    if (isImmortal())
+      return;
     __atomic_fetch_add(&refCount, n << RC_FLAGS_COUNT, __ATOMIC_RELAXED);
   }
 
@@ -108,12 +126,13 @@ class StrongRefCount {
   //
   // Returns true if the flag was set by this operation.
   //
-  // Postcondition: the flag is set.
+  // Postcondition: the flag is set, unless the object is immortal.
   bool tryIncrementAndPin() {
     uint32_t oldval = __atomic_load_n(&refCount, __ATOMIC_RELAXED);
     while (true) {
-      // If the flag is already set, just fail.
-      if (oldval & RC_PINNED_FLAG) {
+      // If the flag is already set, just fail.  Immortal objects are shared
+      // and never unique, so treat them as already pinned.
+      if (oldval & (RC_PINNED_FLAG | RC_IMMORTAL_FLAG)) {
         return false;
       }
 
@@ -130,6 +149,8 @@ class StrongRefCount {
 
   // Increment the reference count, unless the object is deallocating.
   bool tryIncrement() {
+    if (isImmortal())
+      return true;
     // FIXME: this could be better on LL/SC architectures like arm64
     uint32_t oldval = __atomic_fetch_add(&refCount, RC_ONE, __ATOMIC_RELAXED);
     if (oldval & RC_DEALLOCATING_FLAG) {
@@ -192,6 +213,11 @@ class StrongRefCount {
     return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_DEALLOCATING_FLAG;
   }
 
+  // Return true if the object is immortal.
+  bool isImmortal() const {
+    return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_IMMORTAL_FLAG;
+  }
+
 private:
   template <bool ClearPinnedFlag>
   bool doDecrementShouldDeallocate() {
@@ -199,6 +225,8 @@ private:
     // it's already set.
     constexpr uint32_t quantum =
       (ClearPinnedFlag ? RC_ONE + RC_PINNED_FLAG : RC_ONE);
+    if (isImmortal())
+      return false;
     uint32_t newval = __atomic_sub_fetch(&refCount, quantum, __ATOMIC_RELEASE);
 
     assert((!ClearPinnedFlag || !(newval & RC_PINNED_FLAG)) &&
@@ -235,6 +263,8 @@ private:
     // If we're being asked to clear the pinned flag, we can assume
     // it's already set.
     uint32_t delta = (n << RC_FLAGS_COUNT) + (ClearPinnedFlag ? RC_PINNED_FLAG : 0);
+    if (isImmortal())
+      return false;
     uint32_t newval = __atomic_sub_fetch(&refCount, delta, __ATOMIC_RELEASE);
 
     assert((!ClearPinnedFlag || !(newval & RC_PINNED_FLAG)) &&
@@ -273,11 +303,12 @@ private:
 class WeakRefCount {
   uint32_t refCount;
 
+  // The low bit marks an immortal object, as the immortal bit of the strong
+  // count does; unowned and weak retains and releases of it do nothing.
+  // Keeping weak RC_ONE == strong RC_ONE for ordinary objects saves an
+  // instruction in allocation on arm64.
   enum : uint32_t {
-    // There isn't really a flag here.
-    // Making weak RC_ONE == strong RC_ONE saves an
-    // instruction in allocation on arm64.
-    RC_UNUSED_FLAG = 1,
+    RC_IMMORTAL_FLAG = 1,
 
     RC_FLAGS_COUNT = 1,
     RC_FLAGS_MASK = 1,
@@ -294,6 +325,8 @@ class WeakRefCount {
  public:
   enum Initialized_t { Initialized };
 
+  enum Immortal_t { Immortal };
+
   // WeakRefCount must be trivially constructible to avoid ObjC++
   // destruction overhead at runtime. Use WeakRefCount(Initialized) to produce
   // an initialized instance.
@@ -303,6 +336,10 @@ class WeakRefCount {
   constexpr WeakRefCount(Initialized_t)
     : refCount(RC_ONE) { }
 
+  // Weak refcount of an immortal object.
+  constexpr WeakRefCount(Immortal_t)
+    : refCount(RC_ONE | RC_IMMORTAL_FLAG) { }
+
   void init() {
     refCount = RC_ONE;
   }
@@ -315,6 +352,8 @@ class WeakRefCount {
 
   // Increment the weak reference count.
   void increment() {
+    if (isImmortal())
+      return;
     uint32_t newval = __atomic_add_fetch(&refCount, RC_ONE, __ATOMIC_RELAXED);
     assert(newval >= RC_ONE  &&  "weak refcount overflow");
     (void)newval;
@@ -322,6 +361,8 @@ class WeakRefCount {
 
   /// Increment the weak reference count by n.
   void increment(uint32_t n) {
+    if (isImmortal())
+      return;
     uint32_t addval = (n << RC_FLAGS_COUNT);
     uint32_t newval = __atomic_add_fetch(&refCount, addval, __ATOMIC_RELAXED);
     assert(newval >= addval  &&  "weak refcount overflow");
@@ -331,6 +372,8 @@ class WeakRefCount {
   // Decrement the weak reference count.
   // Return true if the caller should deallocate the object.
   bool decrementShouldDeallocate() {
+    if (isImmortal())
+      return false;
     uint32_t oldval = __atomic_fetch_sub(&refCount, RC_ONE, __ATOMIC_RELAXED);
     assert(oldval >= RC_ONE  &&  "weak refcount underflow");
 
@@ -341,6 +384,8 @@ class WeakRefCount {
   /// Decrement the weak reference count.
   /// Return true if the caller should deallocate the object.
   bool decrementShouldDeallocateN(uint32_t n) {
+    if (isImmortal())
+      return false;
     uint32_t subval = (n << RC_FLAGS_COUNT);
     uint32_t oldval = __atomic_fetch_sub(&refCount, subval, __ATOMIC_RELAXED);
     assert(oldval >= subval  &&  "weak refcount underflow");
@@ -354,6 +399,11 @@ class WeakRefCount {
   uint32_t getCount() const {
     return __atomic_load_n(&refCount, __ATOMIC_RELAXED) >> RC_FLAGS_COUNT;
   }
+
+  // Return true if the object is immortal.
+  bool isImmortal() const {
+    return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_IMMORTAL_FLAG;
+  }
 };
 
 static_assert(swift::IsTriviallyConstructible<StrongRefCount>::value,
@@ -47,6 +47,29 @@ const char *_swift_stdlib_strtod_clocale(const char *nptr, double *outResult);
 /// overflow.
 const char *_swift_stdlib_strtof_clocale(const char *nptr, float *outResult);
 
+/// Parse the ASCII text [Str, Str + Length) as a Double, accepting the same
+/// format as strtod_l in the C locale.  Return false if the text is not
+/// entirely a number, or on overflow.
+bool _swift_stdlib_parseDouble_ascii(
+  const char *Str, __swift_size_t Length, double *outResult);
+/// Parse the ASCII text [Str, Str + Length) as a Float, accepting the same
+/// format as strtof_l in the C locale.  Return false if the text is not
+/// entirely a number, or on overflow.
+bool _swift_stdlib_parseFloat_ascii(
+  const char *Str, __swift_size_t Length, float *outResult);
+/// Parse the ASCII digits [Str, Str + Length) in the given radix.  Return
+/// false if the text is empty, contains a character that is not a digit in
+/// that radix, or denotes a value greater than Maximum.
+bool _swift_stdlib_parseUInt64_ascii(
+  const char *Str, __swift_size_t Length, __swift_intptr_t Radix,
+  __swift_uint64_t Maximum, __swift_uint64_t *outResult);
+
+/// Compare the 16 hash table control bytes at Group with Tag.  Bit i of the
+/// result is set if byte i equals Tag, and bit 16 + i is set if byte i marks
+/// an empty bucket.
+__swift_uint32_t _swift_stdlib_HashTable_matchGroup(
+  const __swift_uint8_t *Group, __swift_uint8_t Tag);
+
 struct Metadata;
   
 /// Return the superclass, if any.  The result is nullptr for root
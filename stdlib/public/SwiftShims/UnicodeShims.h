@@ -73,5 +73,31 @@ __swift_int32_t _swift_stdlib_unicode_strToLower(
   __swift_uint16_t *Destination, __swift_int32_t DestinationCapacity,
   const __swift_uint16_t *Source, __swift_int32_t SourceLength);
 
+/// Returns the length of the all-ASCII prefix of the given bytes.
+__swift_intptr_t _swift_stdlib_utf8_countASCII(
+  const __swift_uint8_t *Str, __swift_intptr_t Length);
+
+/// Returns the number of UTF-16 code units needed to hold the given UTF-8, or
+/// -1 if it is ill-formed.
+__swift_intptr_t _swift_stdlib_utf8_measureUTF16(
+  const __swift_uint8_t *Str, __swift_intptr_t Length);
+
+/// Transcodes well-formed UTF-8 to UTF-16, returning the number of code units
+/// written.
+__swift_intptr_t _swift_stdlib_utf8_transcodeToUTF16(
+  const __swift_uint8_t *Str, __swift_intptr_t Length,
+  __swift_uint16_t *Dest);
+
+/// Returns the number of UTF-8 code units needed to hold the given UTF-16,
+/// counting each unpaired surrogate as U+FFFD.
+__swift_intptr_t _swift_stdlib_utf16_measureUTF8(
+  const __swift_uint16_t *Str, __swift_intptr_t Length);
+
+/// Transcodes UTF-16 to UTF-8, replacing unpaired surrogates with U+FFFD and
+/// returning the number of code units written.
+__swift_intptr_t _swift_stdlib_utf16_transcodeToUTF8(
+  const __swift_uint16_t *Str, __swift_intptr_t Length,
+  __swift_uint8_t *Dest);
+
 
 #endif
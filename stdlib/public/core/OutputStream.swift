@@ -242,12 +242,21 @@ internal struct _Stdout : OutputStreamType {
   }
 
   mutating func write(string: String) {
-    // FIXME: buffering?
     // It is important that we use stdio routines in order to correctly
     // interoperate with stdio buffering.
+    let core = string._core
+    if _fastPath(core.hasContiguousStorage && core.isASCII) {
+      // ASCII is already UTF-8, so hand the whole string to stdio at once.
+      _swift_stdlib_fwrite_stdout(UnsafePointer(core.startASCII), 1, core.count)
+      return
+    }
+
+    // Otherwise transcode, taking the lock once rather than once per byte.
+    _swift_stdlib_flockfile_stdout()
     for c in string.utf8 {
-      _swift_stdlib_putchar(Int32(c))
+      _swift_stdlib_putchar_unlocked(Int32(c))
     }
+    _swift_stdlib_funlockfile_stdout()
   }
 }
 
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+import SwiftShims
+
 struct _StringBufferIVars {
   init(_ elementWidth: Int) {
     _sanityCheck(elementWidth == 1 || elementWidth == 2)
@@ -90,6 +92,14 @@ public struct _StringBuffer {
     encoding: Encoding.Type, input: Input, repairIllFormedSequences: Bool,
     minimumCapacity: Int = 0
   ) -> (_StringBuffer?, hadError: Bool) {
+    if encoding == UTF8.self,
+       let utf8 = input as? UnsafeBufferPointer<UTF8.CodeUnit>,
+       let result = _fromContiguousUTF8(utf8,
+         repairIllFormedSequences: repairIllFormedSequences,
+         minimumCapacity: minimumCapacity) {
+      return result
+    }
+
     // Determine how many UTF-16 code units we'll need
     let inputStream = input.generate()
     guard let (utf16Count, isAscii) = UTF16.measure(encoding, input: inputStream,
@@ -126,6 +136,46 @@ public struct _StringBuffer {
     }
   }
 
+  /// Validate and transcode contiguous UTF-8 with the runtime's bulk
+  /// routines, which copy runs of ASCII many bytes at a time.
+  ///
+  /// Returns `nil` if `input` is ill-formed and should be repaired;
+  /// the generic path in `fromCodeUnits` does that.
+  @warn_unused_result
+  static func _fromContiguousUTF8(
+    input: UnsafeBufferPointer<UTF8.CodeUnit>, repairIllFormedSequences: Bool,
+    minimumCapacity: Int
+  ) -> (_StringBuffer?, hadError: Bool)? {
+    let start = input.baseAddress
+    let count = input.count
+    let asciiCount = _swift_stdlib_utf8_countASCII(start, count)
+    if asciiCount == count {
+      let result = _StringBuffer(
+          capacity: max(count, minimumCapacity),
+          initialSize: count,
+          elementWidth: 1)
+      _memcpy(
+        dest: UnsafeMutablePointer(result.start),
+        src: UnsafeMutablePointer(start),
+        size: UInt(count))
+      return (result, false)
+    }
+
+    let tailCount = _swift_stdlib_utf8_measureUTF16(
+      start + asciiCount, count - asciiCount)
+    if tailCount < 0 {
+      return repairIllFormedSequences ? nil : (.None, true)
+    }
+    let utf16Count = asciiCount + tailCount
+    let result = _StringBuffer(
+        capacity: max(utf16Count, minimumCapacity),
+        initialSize: utf16Count,
+        elementWidth: 2)
+    _swift_stdlib_utf8_transcodeToUTF16(
+      start, count, result._storage.baseAddress)
+    return (result, false)
+  }
+
   /// A pointer to the start of this buffer's data area.
   public var start: UnsafeMutablePointer<RawByte> {
     return UnsafeMutablePointer(_storage.baseAddress)
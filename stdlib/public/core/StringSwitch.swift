@@ -0,0 +1,59 @@
+//===--- StringSwitch.swift - Hash dispatch for 'switch' over String ------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// SILGen lowers a long run of `case "literal":` labels in a `switch` over a
+// `String` into a `switch_value` on `_stringSwitchHash(subject)`, followed by
+// a single `~=` test per bucket, instead of a linear chain of `~=` tests.
+// The compiler evaluates the same hash on each literal when it emits the
+// switch (see getStringSwitchHash in lib/SILGen/SILGenPattern.cpp), so the
+// two implementations must be kept in sync.
+//
+//===----------------------------------------------------------------------===//
+
+/// Returns the `switch` dispatch hash of `s`, or -1 if `s` is not known
+/// to consist only of ASCII.
+///
+/// Two ASCII strings are equal iff their code units are equal, so for
+/// them a hash over the code units is consistent with `==`.  A non-ASCII
+/// string can still be canonically equivalent to an ASCII one (for
+/// example, U+212A KELVIN SIGN and "K"), so when this returns -1 the
+/// caller must test every case in order.
+///
+/// The hash is FNV-1a over the code units, seeded with the length, with
+/// the sign bit cleared so that it never collides with -1.
+@warn_unused_result
+public // COMPILER_INTRINSIC
+func _stringSwitchHash(s: String) -> Int32 {
+  let core = s._core
+  if _slowPath(!core.hasContiguousStorage) {
+    return -1
+  }
+
+  let count = core.count
+  var hash: UInt32 = 2166136261 ^ UInt32(truncatingBitPattern: count)
+  if _fastPath(core.elementWidth == 1) {
+    let start = core.startASCII
+    for i in 0..<count {
+      hash = (hash ^ UInt32(start[i])) &* 16777619
+    }
+  } else {
+    let start = core.startUTF16
+    for i in 0..<count {
+      let unit = start[i]
+      if unit >= 0x80 {
+        return -1
+      }
+      hash = (hash ^ UInt32(unit)) &* 16777619
+    }
+  }
+  return Int32(bitPattern: hash & 0x7fff_ffff)
+}
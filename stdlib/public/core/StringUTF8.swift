@@ -16,6 +16,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+import SwiftShims
 
 extension _StringCore {
   /// An integral type that holds a sequence of UTF-8 code units, starting in
@@ -260,6 +261,30 @@ extension String {
   /// To access the underlying memory, invoke
   /// `withUnsafeBufferPointer` on the `ContiguousArray`.
   public var nulTerminatedUTF8: ContiguousArray<UTF8.CodeUnit> {
+    let core = self._core
+    if _fastPath(core.hasContiguousStorage) {
+      let count = core.count
+      if core.isASCII {
+        var result = ContiguousArray<UTF8.CodeUnit>(
+          count: count + 1, repeatedValue: 0)
+        result.withUnsafeMutableBufferPointer {
+          _memcpy(
+            dest: UnsafeMutablePointer($0.baseAddress),
+            src: UnsafeMutablePointer(core.startASCII),
+            size: UInt(count))
+        }
+        return result
+      }
+      let start = UnsafePointer<UTF16.CodeUnit>(core.startUTF16)
+      let utf8Count = _swift_stdlib_utf16_measureUTF8(start, count)
+      var result = ContiguousArray<UTF8.CodeUnit>(
+        count: utf8Count + 1, repeatedValue: 0)
+      result.withUnsafeMutableBufferPointer {
+        _swift_stdlib_utf16_transcodeToUTF8(start, count, $0.baseAddress)
+      }
+      return result
+    }
+
     var result = ContiguousArray<UTF8.CodeUnit>()
     result.reserveCapacity(utf8.count + 1)
     result += utf8
@@ -49,31 +49,82 @@ static unsigned getNumTagBytes(size_t size, unsigned emptyCases,
           numTags < 65536 ? 2 : 4);
 }
 
-/// This is a small and fast implementation of memcpy with a constant count. It
-/// should be a performance win for small constant values where the function
-/// can be inlined, the loop unrolled and the memory accesses merged.
-template <unsigned count> static void small_memcpy(void *dest, const void *src) {
-  uint8_t *d8 = (uint8_t*)dest, *s8 = (uint8_t*)src;
-  for (unsigned int i = 0; i < count; i++) {
-    *d8++ = *s8++;
+// Tags and the case indexes stored in payload areas are unaligned integers of
+// a size known only at runtime.  These helpers dispatch once on the size and
+// then do a single load or store of that width, which is what IRGen does for
+// the same values in non-generic code.
+
+/// Load an unsigned integer of 0, 1, 2 or 4 bytes.
+static inline unsigned loadTagBytes(const uint8_t *addr, unsigned numBytes) {
+  switch (numBytes) {
+  case 0:
+    return 0;
+  case 1:
+    return addr[0];
+  case 2: {
+    uint16_t value;
+    memcpy(&value, addr, sizeof(value));
+    return value;
+  }
+  case 4: {
+    uint32_t value;
+    memcpy(&value, addr, sizeof(value));
+    return value;
+  }
+  default:
+    crash("Tagbyte values should be 1, 2 or 4.");
   }
 }
 
-static inline void small_memcpy(void *dest, const void *src, unsigned count) {
-  // This is specialization of the memcpy line below with
-  // specialization for values of 1, 2 and 4.
-  // memcpy(dst, src, count)
-  if (count == 1) {
-    small_memcpy<1>(dest, src);
-  } else if (count == 2) {
-    small_memcpy<2>(dest, src);
-  } else if (count == 4) {
-    small_memcpy<4>(dest, src);
-  } else {
+/// Store an unsigned integer of 0, 1, 2 or 4 bytes.
+static inline void storeTagBytes(uint8_t *addr, unsigned value,
+                                 unsigned numBytes) {
+  switch (numBytes) {
+  case 0:
+    return;
+  case 1:
+    addr[0] = uint8_t(value);
+    return;
+  case 2: {
+    uint16_t value16 = uint16_t(value);
+    memcpy(addr, &value16, sizeof(value16));
+    return;
+  }
+  case 4: {
+    uint32_t value32 = value;
+    memcpy(addr, &value32, sizeof(value32));
+    return;
+  }
+  default:
     crash("Tagbyte values should be 1, 2 or 4.");
   }
 }
 
+/// Load the case index stored in the first min(4, payloadSize) bytes of a
+/// payload area.
+static inline unsigned loadPayloadValue(const uint8_t *addr,
+                                        size_t payloadSize) {
+  if (payloadSize >= 4)
+    return loadTagBytes(addr, 4);
+  // FIXME: endianness.
+  unsigned value = 0;
+  memcpy(&value, addr, payloadSize);
+  return value;
+}
+
+/// Store a case index into a payload area, zeroing the rest of it.
+static inline void storePayloadValue(uint8_t *addr, unsigned value,
+                                     size_t payloadSize) {
+  if (payloadSize >= 4) {
+    storeTagBytes(addr, value, 4);
+    if (payloadSize > 4)
+      memset(addr + 4, 0, payloadSize - 4);
+    return;
+  }
+  // FIXME: endianness.
+  memcpy(addr, &value, payloadSize);
+}
+
 void
 swift::swift_initEnumValueWitnessTableSinglePayload(ValueWitnessTable *vwtable,
                                                 const TypeLayout *payloadLayout,
@@ -151,13 +202,11 @@ swift::swift_getEnumCaseSinglePayload(const OpaqueValue *value,
   if (emptyCases > payloadNumExtraInhabitants) {
     auto *valueAddr = reinterpret_cast<const uint8_t*>(value);
     auto *extraTagBitAddr = valueAddr + payloadSize;
-    unsigned extraTagBits = 0;
-    // FIXME: endianness
     unsigned numBytes = getNumTagBytes(payloadSize,
                                        emptyCases-payloadNumExtraInhabitants,
                                        1 /*payload case*/);
 
-    small_memcpy(&extraTagBits, extraTagBitAddr, numBytes);
+    unsigned extraTagBits = loadTagBytes(extraTagBitAddr, numBytes);
 
     // If the extra tag bits are zero, we have a valid payload or
     // extra inhabitant (checked below). If nonzero, form the case index from
@@ -168,10 +217,7 @@ swift::swift_getEnumCaseSinglePayload(const OpaqueValue *value,
 
       // In practice we should need no more than four bytes from the payload
       // area.
-      // FIXME: endianness.
-      unsigned caseIndexFromValue = 0;
-      memcpy(&caseIndexFromValue, valueAddr,
-             std::min(size_t(4), payloadSize));
+      unsigned caseIndexFromValue = loadPayloadValue(valueAddr, payloadSize);
       return (caseIndexFromExtraTagBits | caseIndexFromValue)
         + payloadNumExtraInhabitants;
     }
@@ -207,17 +253,7 @@ swift::swift_storeEnumTagSinglePayload(OpaqueValue *value,
   // For payload or extra inhabitant cases, zero-initialize the extra tag bits,
   // if any.
   if (whichCase < (int)payloadNumExtraInhabitants) {
-    // The two most common values for numExtraTagBytes are zero and one.
-    // Try to avoid calling bzero by specializing for these values.
-    if (numExtraTagBytes != 0) {
-      if (numExtraTagBytes == 1) {
-        // Zero a single byte.
-        *((char*)(extraTagBitAddr)) = 0;
-      } else {
-        // Zero the buffer.
-        memset(extraTagBitAddr, 0, numExtraTagBytes);
-      }
-    }
+    storeTagBytes(extraTagBitAddr, 0, numExtraTagBytes);
 
     // If this is the payload case, we're done.
     if (whichCase == -1)
@@ -242,11 +278,8 @@ swift::swift_storeEnumTagSinglePayload(OpaqueValue *value,
   }
   
   // Store into the value.
-  // FIXME: endianness.
-  memcpy(valueAddr, &payloadIndex, std::min(size_t(4), payloadSize));
-  if (payloadSize > 4)
-    memset(valueAddr + 4, 0, payloadSize - 4);
-  memcpy(extraTagBitAddr, &extraTagIndex, numExtraTagBytes);
+  storePayloadValue(valueAddr, payloadIndex, payloadSize);
+  storeTagBytes(extraTagBitAddr, extraTagIndex, numExtraTagBytes);
 }
 
 void
@@ -306,41 +339,27 @@ static MultiPayloadLayout getMultiPayloadLayout(const EnumMetadata *enumType) {
 static void storeMultiPayloadTag(OpaqueValue *value,
                                  MultiPayloadLayout layout,
                                  unsigned tag) {
-  auto tagBytes = reinterpret_cast<char *>(value) + layout.payloadSize;
-  small_memcpy(tagBytes, &tag, layout.numTagBytes);
+  auto tagBytes = reinterpret_cast<uint8_t *>(value) + layout.payloadSize;
+  storeTagBytes(tagBytes, tag, layout.numTagBytes);
 }
 
 static void storeMultiPayloadValue(OpaqueValue *value,
                                    MultiPayloadLayout layout,
                                    unsigned payloadValue) {
-  auto bytes = reinterpret_cast<char *>(value);
-  
-  memcpy(bytes, &payloadValue,
-         std::min(layout.payloadSize, sizeof(payloadValue)));
-  
-  // If the payload is larger than the value, zero out the rest.
-  if (layout.payloadSize > sizeof(payloadValue))
-    memset(bytes + sizeof(payloadValue), 0,
-           layout.payloadSize - sizeof(payloadValue));
+  storePayloadValue(reinterpret_cast<uint8_t *>(value), payloadValue,
+                    layout.payloadSize);
 }
 
 static unsigned loadMultiPayloadTag(const OpaqueValue *value,
                                     MultiPayloadLayout layout) {
-  auto tagBytes = reinterpret_cast<const char *>(value) + layout.payloadSize;
-
-  unsigned tag = 0;
-  small_memcpy(&tag, tagBytes, layout.numTagBytes);
-
-  return tag;
+  auto tagBytes = reinterpret_cast<const uint8_t *>(value) + layout.payloadSize;
+  return loadTagBytes(tagBytes, layout.numTagBytes);
 }
 
 static unsigned loadMultiPayloadValue(const OpaqueValue *value,
                                       MultiPayloadLayout layout) {
-  auto bytes = reinterpret_cast<const char *>(value);
-  unsigned payloadValue = 0;
-  memcpy(&payloadValue, bytes,
-         std::min(layout.payloadSize, sizeof(payloadValue)));
-  return payloadValue;
+  return loadPayloadValue(reinterpret_cast<const uint8_t *>(value),
+                          layout.payloadSize);
 }
 
 void
@@ -363,7 +382,7 @@ swift::swift_storeEnumTagMultiPayload(OpaqueValue *value,
     } else {
       unsigned numPayloadBits = layout.payloadSize * CHAR_BIT;
       whichTag = numPayloads + (whichEmptyCase >> numPayloadBits);
-      whichPayloadValue = whichEmptyCase & ((1U << numPayloads) - 1U);
+      whichPayloadValue = whichEmptyCase & ((1U << numPayloadBits) - 1U);
     }
     storeMultiPayloadTag(value, layout, whichTag);
     storeMultiPayloadValue(value, layout, whichPayloadValue);
@@ -15,9 +15,16 @@
 // implementation is used when ObjC interop is disabled; the ObjC-interoperable
 // version is implemented in ErrorObject.mm.
 //
+// Errors that are values of enums without payloads are thrown in shared,
+// preallocated boxes. The ObjC-interoperable version doesn't share boxes,
+// because its boxes are NSErrors, whose identity is visible once bridged.
+//
 //===----------------------------------------------------------------------===//
 
 #include <stdio.h>
+#include <string.h>
+#include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "Private.h"
@@ -26,6 +33,90 @@
 
 using namespace swift;
 
+namespace {
+  /// A preallocated box holding one value of an enum without payloads.
+  struct SharedErrorBox {
+    const Metadata *Type;
+    const WitnessTable *ErrorConformance;
+    uint32_t Value;
+    SwiftError *Box;
+
+    bool matches(const Metadata *type, const WitnessTable *errorConformance,
+                 uint32_t value) const {
+      return Type == type && ErrorConformance == errorConformance &&
+             Value == value;
+    }
+  };
+}
+
+static Lazy<ConcurrentMap<size_t, SharedErrorBox>> SharedErrorBoxes;
+
+/// Get the bits of the value at \c value if values of \c type can be kept
+/// in shared boxes.
+static bool getSharedErrorBoxValue(const Metadata *type,
+                                   const OpaqueValue *value,
+                                   uint32_t &bits) {
+  if (type->getKind() != MetadataKind::Enum)
+    return false;
+  auto description = static_cast<const EnumMetadata *>(type)->Description;
+  if (description->Enum.getNumPayloadCases() != 0)
+    return false;
+  auto vw = type->getValueWitnesses();
+  if (!vw->isPOD() || vw->getSize() > sizeof(bits))
+    return false;
+
+  bits = 0;
+  memcpy(&bits, value, vw->getSize());
+  return true;
+}
+
+static size_t hashSharedErrorBoxKey(const Metadata *type,
+                                    const WitnessTable *errorConformance,
+                                    uint32_t value) {
+  // A simple hash function, like the one for the conformance cache.
+  return (size_t)type + ((size_t)errorConformance >> 2) + value;
+}
+
+/// Find the shared box holding a value equal to \c value, if values of
+/// \c type are boxed in shared, preallocated boxes and one was created already.
+///
+/// Values of enums without payloads are trivial and immutable, and there are
+/// few of them, so throwing one need not allocate a box each time. The
+/// returned box is not retained.
+static SwiftError *findSharedErrorBox(const Metadata *type,
+                                      const WitnessTable *errorConformance,
+                                      const OpaqueValue *value) {
+  uint32_t bits;
+  if (!getSharedErrorBoxValue(type, value, bits))
+    return nullptr;
+
+  auto &Bucket = SharedErrorBoxes.get().findOrAllocateNode(
+      hashSharedErrorBoxKey(type, errorConformance, bits));
+  for (auto &Entry : Bucket)
+    if (Entry.matches(type, errorConformance, bits))
+      return Entry.Box;
+  return nullptr;
+}
+
+/// Record \c box, which holds a copy of \c value, as the shared box for that
+/// value. Returns false, doing nothing, if values of \c type are not boxed
+/// this way. Otherwise the caller must retain the box on the cache's behalf,
+/// so it is never deallocated.
+static bool addSharedErrorBox(const Metadata *type,
+                              const WitnessTable *errorConformance,
+                              const OpaqueValue *value, SwiftError *box) {
+  uint32_t bits;
+  if (!getSharedErrorBoxValue(type, value, bits))
+    return false;
+
+  // If two threads race to add the same value, both boxes are kept, and
+  // lookups return whichever is found first.
+  auto &Bucket = SharedErrorBoxes.get().findOrAllocateNode(
+      hashSharedErrorBoxKey(type, errorConformance, bits));
+  Bucket.push_front(SharedErrorBox{type, errorConformance, bits, box});
+  return true;
+}
+
 /// Determine the size and alignment of an ErrorType box containing the given
 /// type.
 static std::pair<size_t, size_t>
@@ -67,6 +158,16 @@ swift::swift_allocError(const swift::Metadata *type,
                         const swift::WitnessTable *errorConformance,
                         OpaqueValue *initialValue,
                         bool isTake) {
+  // Reuse the shared box for this value, if there is one. Such values are
+  // trivial, so there is nothing to do to take or copy them.
+  if (initialValue) {
+    if (auto shared = findSharedErrorBox(type, errorConformance,
+                                         initialValue)) {
+      swift_retain(shared);
+      return BoxPair{shared, shared->getValue()};
+    }
+  }
+
   auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
   
   auto allocated = swift_allocObject(&ErrorTypeMetadata,
@@ -84,6 +185,11 @@ swift::swift_allocError(const swift::Metadata *type,
       type->vw_initializeWithTake(valuePtr, initialValue);
     else
       type->vw_initializeWithCopy(valuePtr, initialValue);
+
+    // The box is fully initialized, so it can be shared with later throws of
+    // the same value.
+    if (addSharedErrorBox(type, errorConformance, valuePtr, error))
+      swift_retain(allocated);
   }
   
   return BoxPair{allocated, valuePtr};
@@ -0,0 +1,51 @@
+//===--- HashedCollections.cpp - Dictionary and Set probing helpers -------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// The native storage of Dictionary and Set keeps one control byte per bucket:
+// either 0x80 for an empty bucket, or the top 7 bits of the hash value of the
+// key stored there.  Lookups compare a whole group of control bytes against
+// the tag of the key being searched for, and only compare keys where the tags
+// match.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// The number of control bytes examined at once.
+static const unsigned GroupSize = 16;
+
+// Occupied buckets have tags below 0x80, so only empty buckets have the high
+// bit set.
+
+extern "C" uint32_t _swift_stdlib_HashTable_matchGroup(const uint8_t *Group,
+                                                       uint8_t Tag) {
+#if defined(__SSE2__)
+  __m128i Control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Group));
+  uint32_t Matches = uint32_t(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(Control, _mm_set1_epi8(char(Tag)))));
+  uint32_t Empty = uint32_t(_mm_movemask_epi8(Control));
+#else
+  uint32_t Matches = 0;
+  uint32_t Empty = 0;
+  for (unsigned i = 0; i != GroupSize; ++i) {
+    if (Group[i] == Tag)
+      Matches |= 1U << i;
+    else if (Group[i] & 0x80)
+      Empty |= 1U << i;
+  }
+#endif
+  return Matches | (Empty << GroupSize);
+}
@@ -18,17 +18,25 @@
 #include "swift/Runtime/Heap.h"
 #include "Private.h"
 #include "swift/Runtime/Debug.h"
+#include "HeapProfiler.h"
 #include <stdlib.h>
 
 using namespace swift;
 
-void *swift::swift_slowAlloc(size_t size, size_t alignMask) {
+void *swift::_swift_slowAllocUnprofiled(size_t size, size_t alignMask) {
   // FIXME: use posix_memalign if alignMask is larger than the system guarantee.
   void *p = malloc(size);
   if (!p) swift::crash("Could not allocate memory.");
   return p;
 }
 
+void *swift::swift_slowAlloc(size_t size, size_t alignMask) {
+  void *p = _swift_slowAllocUnprofiled(size, alignMask);
+  SWIFT_HEAP_PROFILER_RECORD_ALLOCATION(p, size, nullptr);
+  return p;
+}
+
 void swift::swift_slowDealloc(void *ptr, size_t bytes, size_t alignMask) {
+  SWIFT_HEAP_PROFILER_RECORD_DEALLOCATION(ptr);
   free(ptr);
 }
@@ -46,6 +46,7 @@
 # define SWIFT_RELEASE()
 # define SWIFT_RETAIN()
 #endif
+#include "HeapProfiler.h"
 #include "Leaks.h"
 
 using namespace swift;
@@ -62,7 +63,7 @@ _swift_allocObject_(HeapMetadata const *metadata, size_t requiredSize,
                     size_t requiredAlignmentMask) {
   assert(isAlignmentMask(requiredAlignmentMask));
   auto object = reinterpret_cast<HeapObject *>(
-                  swift_slowAlloc(requiredSize, requiredAlignmentMask));
+      _swift_slowAllocUnprofiled(requiredSize, requiredAlignmentMask));
   // FIXME: this should be a placement new but that adds a null check
   object->metadata = metadata;
   object->refCount.init();
@@ -71,6 +72,9 @@ _swift_allocObject_(HeapMetadata const *metadata, size_t requiredSize,
   // If leak tracking is enabled, start tracking this object.
   SWIFT_LEAKS_START_TRACKING_OBJECT(object);
 
+  // Unlike swift_slowAlloc, we know the type of what is being allocated.
+  SWIFT_HEAP_PROFILER_RECORD_ALLOCATION(object, requiredSize, metadata);
+
   return object;
 }
 auto swift::_swift_allocObject = _swift_allocObject_;
@@ -415,7 +419,8 @@ HeapObject *swift::swift_tryPin(HeapObject *object) {
     return object;
   }
 
-  // If setting the flag failed, it's because it was already set.
+  // If setting the flag failed, it's because it was already set, or the
+  // object is immortal.
   // Return nil so that the object will be deallocated later.
   return nullptr;
 }
@@ -635,6 +640,22 @@ void swift::swift_deallocObject(HeapObject *object, size_t allocatedSize,
 extern "C" void swift_fixLifetime(OpaqueValue *value) {
 }
 
+// Loading from a weak reference never writes to it, so any number of threads
+// may load from the same reference concurrently without a lock: a load is one
+// atomic load of the pointer and, if it is non-null, an increment of the
+// strong count that fails once the object has begun deallocating.  A weak
+// reference to a deallocated object keeps its memory alive through the
+// unowned count until the reference is assigned to or destroyed, which, as
+// for any other variable, must not race with loads of the same reference.
+
+static HeapObject *loadWeakValue(WeakReference *ref) {
+  return __atomic_load_n(&ref->Value, __ATOMIC_RELAXED);
+}
+
+static HeapObject *exchangeWeakValue(WeakReference *ref, HeapObject *value) {
+  return __atomic_exchange_n(&ref->Value, value, __ATOMIC_RELAXED);
+}
+
 void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
   ref->Value = value;
   swift_unownedRetain(value);
@@ -642,19 +663,13 @@ void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
 
 void swift::swift_weakAssign(WeakReference *ref, HeapObject *newValue) {
   swift_unownedRetain(newValue);
-  auto oldValue = ref->Value;
-  ref->Value = newValue;
+  auto oldValue = exchangeWeakValue(ref, newValue);
   swift_unownedRelease(oldValue);
 }
 
 HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
-  auto object = ref->Value;
+  auto object = loadWeakValue(ref);
   if (object == nullptr) return nullptr;
-  if (object->refCount.isDeallocating()) {
-    swift_unownedRelease(object);
-    ref->Value = nullptr;
-    return nullptr;
-  }
   return swift_tryRetain(object);
 }
 
@@ -665,19 +680,14 @@ HeapObject *swift::swift_weakTakeStrong(WeakReference *ref) {
 }
 
 void swift::swift_weakDestroy(WeakReference *ref) {
-  auto tmp = ref->Value;
-  ref->Value = nullptr;
+  auto tmp = exchangeWeakValue(ref, nullptr);
   swift_unownedRelease(tmp);
 }
 
 void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
-  auto object = src->Value;
-  if (object == nullptr) {
+  auto object = loadWeakValue(src);
+  if (object == nullptr || object->refCount.isDeallocating()) {
     dest->Value = nullptr;
-  } else if (object->refCount.isDeallocating()) {
-    src->Value = nullptr;
-    dest->Value = nullptr;
-    swift_unownedRelease(object);
   } else {
     dest->Value = object;
     swift_unownedRetain(object);
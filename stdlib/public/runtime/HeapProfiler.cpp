@@ -0,0 +1,407 @@
+//===--- HeapProfiler.cpp - Sampling heap profiler ------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// See HeapProfiler.h for a description of this profiler and its output.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeapProfiler.h"
+#include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Metadata.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+
+using namespace swift;
+
+bool swift::_swift_heapProfilerEnabled = false;
+
+//===----------------------------------------------------------------------===//
+//                                   State
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The deepest call stack recorded for a sample.
+const int MaxFrames = 64;
+
+/// The profiler's own frames at the top of each recorded stack.
+const int ProfilerFrames = 2;
+
+/// A call stack and the metadata of the objects allocated there.
+struct SampleSite {
+  std::vector<void *> Stack;
+  const HeapMetadata *Metadata;
+
+  bool operator<(const SampleSite &other) const {
+    if (Metadata != other.Metadata)
+      return Metadata < other.Metadata;
+    return Stack < other.Stack;
+  }
+};
+
+/// Sampled allocations, not yet scaled up to estimates.
+struct SampleCounts {
+  uint64_t InUseObjects = 0;
+  uint64_t InUseBytes = 0;
+  uint64_t AllocatedObjects = 0;
+  uint64_t AllocatedBytes = 0;
+};
+
+typedef std::map<SampleSite, SampleCounts> SampleMap;
+
+struct LiveSample {
+  SampleMap::iterator Site;
+  size_t Size;
+};
+
+struct ProfilerState {
+  pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+  SampleMap Samples;
+  std::unordered_map<void *, LiveSample> LiveSamples;
+
+  ProfilerState();
+};
+
+/// The sampling state of one thread.
+struct ThreadState {
+  /// The number of bytes this thread may still allocate before its next
+  /// sample, or 0 if no interval has been chosen yet.
+  size_t BytesUntilSample = 0;
+
+  uint64_t RandomState = 0;
+
+  /// Set while this thread is inside the profiler, which may allocate.
+  bool InProfiler = false;
+};
+
+/// The key for each thread's ThreadState, which is freed when the thread
+/// exits.
+struct ThreadStateKey {
+  pthread_key_t Key;
+
+  ThreadStateKey() {
+    pthread_key_create(&Key, [](void *state) {
+      delete static_cast<ThreadState *>(state);
+    });
+  }
+};
+}
+
+/// The file the profile is written to.
+static const char *ProfilePath;
+
+/// The mean number of bytes allocated between samples.
+static size_t SampleRate = 512 * 1024;
+
+static Lazy<ProfilerState> State;
+
+static Lazy<ThreadStateKey> ThreadStates;
+
+/// A filter on addresses that have ever been sampled, so that most frees
+/// do not need to take the lock.  Bits are never cleared.
+static std::atomic<uint64_t> SampledAddressFilter[1024];
+
+/// Set by the SIGUSR2 handler; the profile is written at the next sample.
+static std::atomic<bool> WriteRequested;
+
+/// Returns the calling thread's sampling state, creating it if needed.
+///
+/// The state is allocated with operator new, which the profiler does not
+/// see.
+static ThreadState &getThreadState() {
+  pthread_key_t Key = ThreadStates.get().Key;
+  auto *Thread = static_cast<ThreadState *>(pthread_getspecific(Key));
+  if (LLVM_LIKELY(Thread != nullptr))
+    return *Thread;
+  Thread = new ThreadState();
+  pthread_setspecific(Key, Thread);
+  return *Thread;
+}
+
+//===----------------------------------------------------------------------===//
+//                                  Sampling
+//===----------------------------------------------------------------------===//
+
+/// Returns a random interval between samples.  The intervals are
+/// exponentially distributed, so that every byte is equally likely to be
+/// sampled regardless of the pattern of allocation sizes.
+static size_t getNextSampleInterval(ThreadState &thread) {
+  uint64_t &Random = thread.RandomState;
+  if (Random == 0)
+    Random = reinterpret_cast<uintptr_t>(&thread) | 1;
+  Random = Random * 6364136223846793005ULL + 1442695040888963407ULL;
+  // A uniform value in (0, 1].
+  double Uniform = double((Random >> 11) + 1) / double(1ULL << 53);
+  return size_t(-std::log(Uniform) * double(SampleRate)) + 1;
+}
+
+static std::atomic<uint64_t> &getFilterWord(void *ptr, uint64_t &bit) {
+  uintptr_t Hash = reinterpret_cast<uintptr_t>(ptr) >> 4;
+  Hash ^= Hash >> 16;
+  bit = uint64_t(1) << (Hash % 64);
+  return SampledAddressFilter[(Hash / 64) % 1024];
+}
+
+static void writeProfiles(const ProfilerState &state);
+
+LLVM_ATTRIBUTE_NOINLINE
+static void takeSample(void *ptr, size_t size, const HeapMetadata *metadata) {
+  void *Frames[MaxFrames];
+  int FrameCount = backtrace(Frames, MaxFrames);
+  int FirstFrame = std::min(FrameCount, ProfilerFrames);
+
+  uint64_t Bit;
+  getFilterWord(ptr, Bit).fetch_or(Bit, std::memory_order_relaxed);
+
+  ProfilerState &state = State.get();
+  pthread_mutex_lock(&state.Mutex);
+  SampleSite Key = {
+    std::vector<void *>(Frames + FirstFrame, Frames + FrameCount), metadata
+  };
+  auto Site = state.Samples.insert({Key, SampleCounts()}).first;
+  SampleCounts &Counts = Site->second;
+  ++Counts.InUseObjects;
+  Counts.InUseBytes += size;
+  ++Counts.AllocatedObjects;
+  Counts.AllocatedBytes += size;
+
+  // Memory freed without swift_slowDealloc is never seen being freed. If its
+  // address was sampled and is now handed out again, the old sample is gone.
+  LiveSample &Live = state.LiveSamples[ptr];
+  if (Live.Size != 0) {
+    --Live.Site->second.InUseObjects;
+    Live.Site->second.InUseBytes -= Live.Size;
+  }
+  Live = {Site, size};
+
+  if (WriteRequested.exchange(false, std::memory_order_relaxed))
+    writeProfiles(state);
+  pthread_mutex_unlock(&state.Mutex);
+}
+
+void swift::_swift_heapProfilerRecordAllocation(void *ptr, size_t size,
+                                                const HeapMetadata *metadata) {
+  ThreadState &Thread = getThreadState();
+  if (LLVM_LIKELY(Thread.BytesUntilSample > size)) {
+    Thread.BytesUntilSample -= size;
+    return;
+  }
+  if (Thread.InProfiler)
+    return;
+  Thread.InProfiler = true;
+
+  if (Thread.BytesUntilSample == 0) {
+    // This is the first allocation on this thread.
+    Thread.BytesUntilSample = getNextSampleInterval(Thread);
+    if (Thread.BytesUntilSample > size) {
+      Thread.BytesUntilSample -= size;
+      Thread.InProfiler = false;
+      return;
+    }
+  }
+  Thread.BytesUntilSample = getNextSampleInterval(Thread);
+  takeSample(ptr, size, metadata);
+  Thread.InProfiler = false;
+}
+
+void swift::_swift_heapProfilerRecordDeallocation(void *ptr) {
+  uint64_t Bit;
+  if (LLVM_LIKELY(!(getFilterWord(ptr, Bit).load(std::memory_order_relaxed) &
+                    Bit)))
+    return;
+  // Writing the profile frees memory while holding the lock.
+  if (getThreadState().InProfiler)
+    return;
+
+  ProfilerState &state = State.get();
+  pthread_mutex_lock(&state.Mutex);
+  auto Live = state.LiveSamples.find(ptr);
+  if (Live != state.LiveSamples.end()) {
+    SampleCounts &Counts = Live->second.Site->second;
+    --Counts.InUseObjects;
+    Counts.InUseBytes -= Live->second.Size;
+    state.LiveSamples.erase(Live);
+  }
+  pthread_mutex_unlock(&state.Mutex);
+}
+
+//===----------------------------------------------------------------------===//
+//                                   Output
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// Counts scaled up from the samples to estimates of all allocations.
+struct EstimatedCounts {
+  double InUseObjects = 0;
+  double InUseBytes = 0;
+  double AllocatedObjects = 0;
+  double AllocatedBytes = 0;
+};
+}
+
+/// Scales sampled counts up the same way pprof does for heap_v2 profiles:
+/// an allocation of N bytes is sampled with probability 1 - exp(-N / rate).
+static void addEstimate(double &objects, double &bytes, uint64_t sampledObjects,
+                        uint64_t sampledBytes) {
+  if (sampledObjects == 0 || sampledBytes == 0)
+    return;
+  double AverageSize = double(sampledBytes) / double(sampledObjects);
+  double Scale = 1 / (1 - std::exp(-AverageSize / double(SampleRate)));
+  objects += double(sampledObjects) * Scale;
+  bytes += double(sampledBytes) * Scale;
+}
+
+/// Write the samples in the gperftools heap profile format.
+static void writeHeapProfile(const ProfilerState &state, FILE *out) {
+  SampleCounts Total;
+  for (auto &Sample : state.Samples) {
+    Total.InUseObjects += Sample.second.InUseObjects;
+    Total.InUseBytes += Sample.second.InUseBytes;
+    Total.AllocatedObjects += Sample.second.AllocatedObjects;
+    Total.AllocatedBytes += Sample.second.AllocatedBytes;
+  }
+
+  auto printCounts = [&](const SampleCounts &counts) {
+    fprintf(out, "%6llu: %8llu [%6llu: %8llu] @",
+            (unsigned long long)counts.InUseObjects,
+            (unsigned long long)counts.InUseBytes,
+            (unsigned long long)counts.AllocatedObjects,
+            (unsigned long long)counts.AllocatedBytes);
+  };
+
+  fprintf(out, "heap profile: ");
+  printCounts(Total);
+  fprintf(out, " heap_v2/%zu\n", SampleRate);
+  for (auto &Sample : state.Samples) {
+    printCounts(Sample.second);
+    for (void *Frame : Sample.first.Stack)
+      fprintf(out, " 0x%llx", (unsigned long long)(uintptr_t)Frame);
+    fprintf(out, "\n");
+  }
+
+  // pprof needs the memory map to symbolize the stacks.
+  fprintf(out, "\nMAPPED_LIBRARIES:\n");
+  if (FILE *Maps = fopen("/proc/self/maps", "r")) {
+    char Buffer[4096];
+    size_t Length;
+    while ((Length = fread(Buffer, 1, sizeof(Buffer), Maps)) != 0)
+      fwrite(Buffer, 1, Length, out);
+    fclose(Maps);
+  }
+}
+
+/// Write estimated totals for each type, largest first.
+static void writeTypeSummary(const ProfilerState &state, FILE *out) {
+  std::map<const HeapMetadata *, EstimatedCounts> ByType;
+  for (auto &Sample : state.Samples) {
+    EstimatedCounts &Counts = ByType[Sample.first.Metadata];
+    addEstimate(Counts.InUseObjects, Counts.InUseBytes,
+                Sample.second.InUseObjects, Sample.second.InUseBytes);
+    addEstimate(Counts.AllocatedObjects, Counts.AllocatedBytes,
+                Sample.second.AllocatedObjects, Sample.second.AllocatedBytes);
+  }
+
+  std::vector<std::pair<const HeapMetadata *, EstimatedCounts>> Sorted(
+      ByType.begin(), ByType.end());
+  std::sort(Sorted.begin(), Sorted.end(),
+            [](const std::pair<const HeapMetadata *, EstimatedCounts> &lhs,
+               const std::pair<const HeapMetadata *, EstimatedCounts> &rhs) {
+              return lhs.second.AllocatedBytes > rhs.second.AllocatedBytes;
+            });
+
+  for (auto &Type : Sorted) {
+    std::string Name =
+        Type.first ? nameForMetadata(Type.first) : std::string("<raw>");
+    fprintf(out, "%6.0f: %8.0f [%6.0f: %8.0f] %s\n",
+            Type.second.InUseObjects, Type.second.InUseBytes,
+            Type.second.AllocatedObjects, Type.second.AllocatedBytes,
+            Name.c_str());
+  }
+}
+
+static void writeProfiles(const ProfilerState &state) {
+  if (FILE *Out = fopen(ProfilePath, "w")) {
+    writeHeapProfile(state, Out);
+    fclose(Out);
+  } else {
+    fprintf(stderr, "swift: could not write heap profile to %s\n",
+            ProfilePath);
+    return;
+  }
+
+  std::string TypesPath = std::string(ProfilePath) + ".types";
+  if (FILE *Out = fopen(TypesPath.c_str(), "w")) {
+    writeTypeSummary(state, Out);
+    fclose(Out);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+//                            Init and Deinit Code
+//===----------------------------------------------------------------------===//
+
+static void writeProfilesAtExit() {
+  getThreadState().InProfiler = true;
+  ProfilerState &state = State.get();
+  pthread_mutex_lock(&state.Mutex);
+  writeProfiles(state);
+  pthread_mutex_unlock(&state.Mutex);
+}
+
+static void requestWrite(int) {
+  WriteRequested.store(true, std::memory_order_relaxed);
+}
+
+/// Set up writing the profile.  This happens when the first sample is
+/// taken, so it only happens if the profiler is enabled.
+ProfilerState::ProfilerState() {
+  atexit(writeProfilesAtExit);
+
+  // Leave SIGUSR2 alone if the program handles it itself.
+  struct sigaction Old;
+  if (sigaction(SIGUSR2, nullptr, &Old) == 0 && Old.sa_handler == SIG_DFL) {
+    struct sigaction Action;
+    memset(&Action, 0, sizeof(Action));
+    Action.sa_handler = requestWrite;
+    sigemptyset(&Action.sa_mask);
+    Action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &Action, nullptr);
+  }
+}
+
+/// Only reads the environment; everything else is set up lazily.
+__attribute__((constructor))
+static void initializeHeapProfiler() {
+  const char *Path = getenv("SWIFT_HEAP_PROFILE");
+  if (!Path || !*Path)
+    return;
+  ProfilePath = strdup(Path);
+
+  if (const char *Rate = getenv("SWIFT_HEAP_PROFILE_RATE")) {
+    unsigned long long Value = strtoull(Rate, nullptr, 10);
+    if (Value != 0)
+      SampleRate = size_t(Value);
+  }
+
+  _swift_heapProfilerEnabled = true;
+}
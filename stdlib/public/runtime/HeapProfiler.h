@@ -0,0 +1,87 @@
+//===--- HeapProfiler.h - Sampling heap profiler ----------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A sampling profiler for memory allocated by swift_slowAlloc and
+// swift_allocObject.  It is only built on Linux, where SWIFT_RUNTIME_ENABLE_
+// HEAP_PROFILER is defined, because its output relies on /proc/self/maps.
+// It is off unless the SWIFT_HEAP_PROFILE environment variable names an
+// output file when the runtime is loaded; when off, each allocation and
+// deallocation pays for one load and a not-taken branch.
+//
+// When on, the profiler records the call stack, and the heap metadata for
+// objects, of one allocation in about every SWIFT_HEAP_PROFILE_RATE bytes
+// (512 KiB by default).  Once it has taken a sample, it writes two files at
+// exit, and at the first sample after the process receives SIGUSR2 unless
+// the program installed its own handler for that signal:
+//
+// - $SWIFT_HEAP_PROFILE, in the gperftools "heap_v2" format, which pprof
+//   reads:  pprof --alloc_space ./program $SWIFT_HEAP_PROFILE
+//
+// - $SWIFT_HEAP_PROFILE.types, with one line per heap metadata, largest
+//   first, in the form
+//     <in-use objs>: <in-use bytes> [<alloc objs>: <alloc bytes>] <type>
+//   Raw allocations have no type and are reported as "<raw>".
+//
+// All counts are estimates scaled up from the samples, as pprof does.
+//
+// Frees are only seen through swift_slowDealloc.  A sampled allocation that
+// is freed some other way keeps counting as in use until its address is
+// sampled again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_STDLIB_RUNTIME_HEAPPROFILER_H
+#define SWIFT_STDLIB_RUNTIME_HEAPPROFILER_H
+
+#include "llvm/Support/Compiler.h"
+#include <cstddef>
+
+#if SWIFT_RUNTIME_ENABLE_HEAP_PROFILER
+
+namespace swift {
+struct HeapMetadata;
+
+/// True if SWIFT_HEAP_PROFILE was set when the runtime was loaded.  Never
+/// changes afterwards.
+extern LLVM_LIBRARY_VISIBILITY bool _swift_heapProfilerEnabled;
+
+/// Count an allocation towards the next sample, taking one if it is due.
+LLVM_LIBRARY_VISIBILITY LLVM_ATTRIBUTE_NOINLINE
+void _swift_heapProfilerRecordAllocation(void *ptr, size_t size,
+                                         const HeapMetadata *metadata);
+
+/// Forget a sampled allocation when it is freed.
+LLVM_LIBRARY_VISIBILITY LLVM_ATTRIBUTE_NOINLINE
+void _swift_heapProfilerRecordDeallocation(void *ptr);
+}
+
+#define SWIFT_HEAP_PROFILER_RECORD_ALLOCATION(ptr, size, metadata)             \
+  do {                                                                         \
+    if (LLVM_UNLIKELY(swift::_swift_heapProfilerEnabled))                      \
+      swift::_swift_heapProfilerRecordAllocation(ptr, size, metadata);         \
+  } while (0)
+#define SWIFT_HEAP_PROFILER_RECORD_DEALLOCATION(ptr)                           \
+  do {                                                                         \
+    if (LLVM_UNLIKELY(swift::_swift_heapProfilerEnabled))                      \
+      swift::_swift_heapProfilerRecordDeallocation(ptr);                       \
+  } while (0)
+
+#else
+
+#define SWIFT_HEAP_PROFILER_RECORD_ALLOCATION(ptr, size, metadata)             \
+  do {} while (0)
+#define SWIFT_HEAP_PROFILER_RECORD_DEALLOCATION(ptr)                           \
+  do {} while (0)
+
+#endif
+
+#endif
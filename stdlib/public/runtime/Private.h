@@ -41,6 +41,11 @@ namespace swift {
   extern "C" LLVM_LIBRARY_VISIBILITY LLVM_ATTRIBUTE_NORETURN
   void _swift_abortRetainUnowned(const void *object);
 
+  /// Allocate memory like swift_slowAlloc, but without telling the heap
+  /// profiler, for callers that report the allocation themselves.
+  LLVM_LIBRARY_VISIBILITY
+  void *_swift_slowAllocUnprofiled(size_t size, size_t alignMask);
+
   /// Is the given value a valid alignment mask?
   static inline bool isAlignmentMask(size_t mask) {
     // mask          == xyz01111...
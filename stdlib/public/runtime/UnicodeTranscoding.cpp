@@ -0,0 +1,254 @@
+//===--- UnicodeTranscoding.cpp - UTF-8 and UTF-16 bulk conversion --------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Validation and transcoding of contiguous UTF-8 and UTF-16 buffers, used by
+// the standard library when it creates strings from byte buffers and when it
+// produces C strings.  Runs of ASCII are processed 16 bytes at a time; other
+// sequences are decoded one scalar at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// Returns the number of bytes in the longest all-ASCII prefix of
+/// [Str, Str + Length).
+static intptr_t countASCIIPrefix(const uint8_t *Str, intptr_t Length) {
+  intptr_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 16 <= Length; i += 16) {
+    __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Str + i));
+    int NonASCII = _mm_movemask_epi8(Chunk);
+    if (NonASCII != 0)
+      return i + __builtin_ctz(NonASCII);
+  }
+#else
+  for (; i + 8 <= Length; i += 8) {
+    uint64_t Chunk;
+    memcpy(&Chunk, Str + i, sizeof(Chunk));
+    if (Chunk & 0x8080808080808080ULL)
+      break;
+  }
+#endif
+  while (i < Length && Str[i] < 0x80)
+    ++i;
+  return i;
+}
+
+static bool isContinuationByte(uint8_t Byte) {
+  return (Byte & 0xC0) == 0x80;
+}
+
+/// Returns the length of the well-formed multi-byte sequence at the start of
+/// [Str, Str + Length), or 0 if it is ill-formed.
+static intptr_t getMultiByteSequenceLength(const uint8_t *Str,
+                                           intptr_t Length) {
+  uint8_t Lead = Str[0];
+  if (Lead < 0xC2) {
+    // A continuation byte, or the lead byte of an overlong 2-byte sequence.
+    return 0;
+  }
+  if (Lead < 0xE0)
+    return Length >= 2 && isContinuationByte(Str[1]) ? 2 : 0;
+
+  // The second byte of 3- and 4-byte sequences has a narrower range for some
+  // lead bytes, to rule out overlong encodings, surrogates, and values above
+  // U+10FFFF.
+  uint8_t Min = 0x80, Max = 0xBF;
+  if (Lead < 0xF0) {
+    if (Lead == 0xE0)
+      Min = 0xA0;
+    else if (Lead == 0xED)
+      Max = 0x9F;
+    if (Length < 3 || Str[1] < Min || Str[1] > Max ||
+        !isContinuationByte(Str[2]))
+      return 0;
+    return 3;
+  }
+  if (Lead < 0xF5) {
+    if (Lead == 0xF0)
+      Min = 0x90;
+    else if (Lead == 0xF4)
+      Max = 0x8F;
+    if (Length < 4 || Str[1] < Min || Str[1] > Max ||
+        !isContinuationByte(Str[2]) || !isContinuationByte(Str[3]))
+      return 0;
+    return 4;
+  }
+  return 0;
+}
+
+extern "C" intptr_t _swift_stdlib_utf8_countASCII(const uint8_t *Str,
+                                                  intptr_t Length) {
+  return countASCIIPrefix(Str, Length);
+}
+
+extern "C" intptr_t _swift_stdlib_utf8_measureUTF16(const uint8_t *Str,
+                                                    intptr_t Length) {
+  intptr_t UTF16Count = 0;
+  intptr_t i = 0;
+  while (i < Length) {
+    if (Str[i] < 0x80) {
+      intptr_t RunLength = countASCIIPrefix(Str + i, Length - i);
+      i += RunLength;
+      UTF16Count += RunLength;
+      continue;
+    }
+    intptr_t SequenceLength = getMultiByteSequenceLength(Str + i, Length - i);
+    if (SequenceLength == 0)
+      return -1;
+    i += SequenceLength;
+    UTF16Count += SequenceLength == 4 ? 2 : 1;
+  }
+  return UTF16Count;
+}
+
+extern "C" intptr_t _swift_stdlib_utf8_transcodeToUTF16(const uint8_t *Str,
+                                                        intptr_t Length,
+                                                        uint16_t *Dest) {
+  uint16_t *Out = Dest;
+  intptr_t i = 0;
+  while (i < Length) {
+    uint32_t Lead = Str[i];
+    if (Lead < 0x80) {
+#if defined(__SSE2__)
+      const __m128i Zero = _mm_setzero_si128();
+      for (; i + 16 <= Length; i += 16, Out += 16) {
+        __m128i Chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(Str + i));
+        if (_mm_movemask_epi8(Chunk) != 0)
+          break;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(Out),
+                         _mm_unpacklo_epi8(Chunk, Zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(Out + 8),
+                         _mm_unpackhi_epi8(Chunk, Zero));
+      }
+#endif
+      while (i < Length && Str[i] < 0x80)
+        *Out++ = Str[i++];
+      continue;
+    }
+
+    if (Lead < 0xE0) {
+      *Out++ = uint16_t(((Lead & 0x1F) << 6) | (Str[i + 1] & 0x3F));
+      i += 2;
+    } else if (Lead < 0xF0) {
+      *Out++ = uint16_t(((Lead & 0x0F) << 12) | ((Str[i + 1] & 0x3F) << 6) |
+                        (Str[i + 2] & 0x3F));
+      i += 3;
+    } else {
+      uint32_t Scalar = ((Lead & 0x07) << 18) | ((Str[i + 1] & 0x3F) << 12) |
+                        ((Str[i + 2] & 0x3F) << 6) | (Str[i + 3] & 0x3F);
+      Scalar -= 0x10000;
+      *Out++ = uint16_t(0xD800 | (Scalar >> 10));
+      *Out++ = uint16_t(0xDC00 | (Scalar & 0x3FF));
+      i += 4;
+    }
+  }
+  return Out - Dest;
+}
+
+#if defined(__SSE2__)
+/// Returns true if the 8 UTF-16 code units at \p Str are all ASCII.
+static bool isASCIIChunk(const uint16_t *Str, __m128i &Chunk) {
+  Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Str));
+  __m128i High = _mm_and_si128(Chunk, _mm_set1_epi16(int16_t(0xFF80)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(High, _mm_setzero_si128())) ==
+         0xFFFF;
+}
+#endif
+
+static bool isHighSurrogate(uint16_t Unit) {
+  return (Unit & 0xFC00) == 0xD800;
+}
+
+static bool isLowSurrogate(uint16_t Unit) {
+  return (Unit & 0xFC00) == 0xDC00;
+}
+
+// Unpaired surrogates are replaced with U+FFFD, as String.UTF8View does.
+
+extern "C" intptr_t _swift_stdlib_utf16_measureUTF8(const uint16_t *Str,
+                                                    intptr_t Length) {
+  intptr_t UTF8Count = 0;
+  intptr_t i = 0;
+  while (i < Length) {
+#if defined(__SSE2__)
+    __m128i Chunk;
+    if (i + 8 <= Length && isASCIIChunk(Str + i, Chunk)) {
+      i += 8;
+      UTF8Count += 8;
+      continue;
+    }
+#endif
+    uint16_t Unit = Str[i++];
+    if (Unit < 0x80) {
+      UTF8Count += 1;
+    } else if (Unit < 0x800) {
+      UTF8Count += 2;
+    } else if (isHighSurrogate(Unit) && i < Length &&
+               isLowSurrogate(Str[i])) {
+      ++i;
+      UTF8Count += 4;
+    } else {
+      UTF8Count += 3;
+    }
+  }
+  return UTF8Count;
+}
+
+extern "C" intptr_t _swift_stdlib_utf16_transcodeToUTF8(const uint16_t *Str,
+                                                        intptr_t Length,
+                                                        uint8_t *Dest) {
+  uint8_t *Out = Dest;
+  intptr_t i = 0;
+  while (i < Length) {
+#if defined(__SSE2__)
+    __m128i Chunk;
+    if (i + 8 <= Length && isASCIIChunk(Str + i, Chunk)) {
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(Out),
+                       _mm_packus_epi16(Chunk, Chunk));
+      i += 8;
+      Out += 8;
+      continue;
+    }
+#endif
+    uint32_t Scalar = Str[i++];
+    if (Scalar < 0x80) {
+      *Out++ = uint8_t(Scalar);
+      continue;
+    }
+    if (Scalar < 0x800) {
+      *Out++ = uint8_t(0xC0 | (Scalar >> 6));
+      *Out++ = uint8_t(0x80 | (Scalar & 0x3F));
+      continue;
+    }
+    if (isHighSurrogate(Scalar) && i < Length && isLowSurrogate(Str[i])) {
+      Scalar = 0x10000 + (((Scalar & 0x3FF) << 10) | (Str[i++] & 0x3FF));
+      *Out++ = uint8_t(0xF0 | (Scalar >> 18));
+      *Out++ = uint8_t(0x80 | ((Scalar >> 12) & 0x3F));
+      *Out++ = uint8_t(0x80 | ((Scalar >> 6) & 0x3F));
+      *Out++ = uint8_t(0x80 | (Scalar & 0x3F));
+      continue;
+    }
+    if (isHighSurrogate(Scalar) || isLowSurrogate(Scalar))
+      Scalar = 0xFFFD;
+    *Out++ = uint8_t(0xE0 | (Scalar >> 12));
+    *Out++ = uint8_t(0x80 | ((Scalar >> 6) & 0x3F));
+    *Out++ = uint8_t(0x80 | (Scalar & 0x3F));
+  }
+  return Out - Dest;
+}
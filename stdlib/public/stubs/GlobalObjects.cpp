@@ -27,6 +27,7 @@ extern "C" _SwiftEmptyArrayStorage _swiftEmptyArrayStorage = {
   // HeapObject header;
   {
     &_TMCs18_EmptyArrayStorage, // isa pointer
+    HeapObject::Immortal
   },
   
   // _SwiftArrayBodyStorage body;
@@ -23,7 +23,9 @@
 #include <sys/resource.h>
 #include <sys/errno.h>
 #include <unistd.h>
+#include <cassert>
 #include <climits>
+#include <cmath>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -32,6 +34,7 @@
 #include <xlocale.h>
 #include <limits>
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MathExtras.h"
 #include "swift/Runtime/Debug.h"
 #include "swift/Basic/Lazy.h"
 
@@ -169,16 +172,439 @@ static uint64_t swift_floatingPointToString(char *Buffer, size_t BufferLength,
   return i;
 }
 
+// Float and Double are printed with the shortest digit string that reads back
+// as the same value, found with Florian Loitsch's Grisu3 algorithm ("Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010).
+// Grisu3 works in 64-bit integer arithmetic and detects the rare inputs
+// (about 0.5% of Doubles) for which it cannot prove its result is shortest;
+// those fall back to trying increasing precisions with snprintf.
+
+namespace {
+/// A floating-point value F * 2^E with a 64-bit significand and no implicit
+/// leading bit.
+struct DiyFp {
+  uint64_t F;
+  int E;
+};
+
+/// A normalized approximation of a power of ten.
+struct CachedPowerOfTen {
+  uint64_t Significand;
+  int16_t BinaryExponent;
+  int16_t DecimalExponent;
+};
+} // end anonymous namespace
+
+/// Powers of ten from 10^-348 to 10^340 in steps of 8, rounded to 64 bits.
+static const CachedPowerOfTen CachedPowersOfTen[] = {
+  {0xfa8fd5a0081c0288ULL, -1220, -348},
+  {0xbaaee17fa23ebf76ULL, -1193, -340},
+  {0x8b16fb203055ac76ULL, -1166, -332},
+  {0xcf42894a5dce35eaULL, -1140, -324},
+  {0x9a6bb0aa55653b2dULL, -1113, -316},
+  {0xe61acf033d1a45dfULL, -1087, -308},
+  {0xab70fe17c79ac6caULL, -1060, -300},
+  {0xff77b1fcbebcdc4fULL, -1034, -292},
+  {0xbe5691ef416bd60cULL, -1007, -284},
+  {0x8dd01fad907ffc3cULL, -980, -276},
+  {0xd3515c2831559a83ULL, -954, -268},
+  {0x9d71ac8fada6c9b5ULL, -927, -260},
+  {0xea9c227723ee8bcbULL, -901, -252},
+  {0xaecc49914078536dULL, -874, -244},
+  {0x823c12795db6ce57ULL, -847, -236},
+  {0xc21094364dfb5637ULL, -821, -228},
+  {0x9096ea6f3848984fULL, -794, -220},
+  {0xd77485cb25823ac7ULL, -768, -212},
+  {0xa086cfcd97bf97f4ULL, -741, -204},
+  {0xef340a98172aace5ULL, -715, -196},
+  {0xb23867fb2a35b28eULL, -688, -188},
+  {0x84c8d4dfd2c63f3bULL, -661, -180},
+  {0xc5dd44271ad3cdbaULL, -635, -172},
+  {0x936b9fcebb25c996ULL, -608, -164},
+  {0xdbac6c247d62a584ULL, -582, -156},
+  {0xa3ab66580d5fdaf6ULL, -555, -148},
+  {0xf3e2f893dec3f126ULL, -529, -140},
+  {0xb5b5ada8aaff80b8ULL, -502, -132},
+  {0x87625f056c7c4a8bULL, -475, -124},
+  {0xc9bcff6034c13053ULL, -449, -116},
+  {0x964e858c91ba2655ULL, -422, -108},
+  {0xdff9772470297ebdULL, -396, -100},
+  {0xa6dfbd9fb8e5b88fULL, -369, -92},
+  {0xf8a95fcf88747d94ULL, -343, -84},
+  {0xb94470938fa89bcfULL, -316, -76},
+  {0x8a08f0f8bf0f156bULL, -289, -68},
+  {0xcdb02555653131b6ULL, -263, -60},
+  {0x993fe2c6d07b7facULL, -236, -52},
+  {0xe45c10c42a2b3b06ULL, -210, -44},
+  {0xaa242499697392d3ULL, -183, -36},
+  {0xfd87b5f28300ca0eULL, -157, -28},
+  {0xbce5086492111aebULL, -130, -20},
+  {0x8cbccc096f5088ccULL, -103, -12},
+  {0xd1b71758e219652cULL, -77, -4},
+  {0x9c40000000000000ULL, -50, 4},
+  {0xe8d4a51000000000ULL, -24, 12},
+  {0xad78ebc5ac620000ULL, 3, 20},
+  {0x813f3978f8940984ULL, 30, 28},
+  {0xc097ce7bc90715b3ULL, 56, 36},
+  {0x8f7e32ce7bea5c70ULL, 83, 44},
+  {0xd5d238a4abe98068ULL, 109, 52},
+  {0x9f4f2726179a2245ULL, 136, 60},
+  {0xed63a231d4c4fb27ULL, 162, 68},
+  {0xb0de65388cc8ada8ULL, 189, 76},
+  {0x83c7088e1aab65dbULL, 216, 84},
+  {0xc45d1df942711d9aULL, 242, 92},
+  {0x924d692ca61be758ULL, 269, 100},
+  {0xda01ee641a708deaULL, 295, 108},
+  {0xa26da3999aef774aULL, 322, 116},
+  {0xf209787bb47d6b85ULL, 348, 124},
+  {0xb454e4a179dd1877ULL, 375, 132},
+  {0x865b86925b9bc5c2ULL, 402, 140},
+  {0xc83553c5c8965d3dULL, 428, 148},
+  {0x952ab45cfa97a0b3ULL, 455, 156},
+  {0xde469fbd99a05fe3ULL, 481, 164},
+  {0xa59bc234db398c25ULL, 508, 172},
+  {0xf6c69a72a3989f5cULL, 534, 180},
+  {0xb7dcbf5354e9beceULL, 561, 188},
+  {0x88fcf317f22241e2ULL, 588, 196},
+  {0xcc20ce9bd35c78a5ULL, 614, 204},
+  {0x98165af37b2153dfULL, 641, 212},
+  {0xe2a0b5dc971f303aULL, 667, 220},
+  {0xa8d9d1535ce3b396ULL, 694, 228},
+  {0xfb9b7cd9a4a7443cULL, 720, 236},
+  {0xbb764c4ca7a44410ULL, 747, 244},
+  {0x8bab8eefb6409c1aULL, 774, 252},
+  {0xd01fef10a657842cULL, 800, 260},
+  {0x9b10a4e5e9913129ULL, 827, 268},
+  {0xe7109bfba19c0c9dULL, 853, 276},
+  {0xac2820d9623bf429ULL, 880, 284},
+  {0x80444b5e7aa7cf85ULL, 907, 292},
+  {0xbf21e44003acdd2dULL, 933, 300},
+  {0x8e679c2f5e44ff8fULL, 960, 308},
+  {0xd433179d9c8cb841ULL, 986, 316},
+  {0x9e19db92b4e31ba9ULL, 1013, 324},
+  {0xeb96bf6ebadf77d9ULL, 1039, 332},
+  {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+static const int CachedPowersMinDecimalExponent = -348;
+static const int CachedPowersDecimalExponentStep = 8;
+
+/// Scaled values are kept in [2^(MinTargetExponent + 64),
+/// 2^(MaxTargetExponent + 64)), so that their integral part fits in 32 bits.
+static const int MinTargetExponent = -60;
+static const int MaxTargetExponent = -32;
+
+static DiyFp normalizeDiyFp(DiyFp X) {
+  unsigned Shift = llvm::countLeadingZeros(X.F);
+  return {X.F << Shift, X.E - int(Shift)};
+}
+
+/// Returns X * Y rounded to the upper 64 bits of the product.
+static DiyFp multiplyDiyFp(DiyFp X, DiyFp Y) {
+  const uint64_t Mask32 = 0xFFFFFFFFu;
+  uint64_t A = X.F >> 32, B = X.F & Mask32;
+  uint64_t C = Y.F >> 32, D = Y.F & Mask32;
+  uint64_t AC = A * C, BC = B * C, AD = A * D, BD = B * D;
+  uint64_t Mid = (BD >> 32) + (AD & Mask32) + (BC & Mask32);
+  // Round to nearest.
+  Mid += 1U << 31;
+  return {AC + (AD >> 32) + (BC >> 32) + (Mid >> 32), X.E + Y.E + 64};
+}
+
+/// Returns a cached power of ten C such that multiplying a normalized DiyFp
+/// with exponent \p E by C yields an exponent in [MinTargetExponent,
+/// MaxTargetExponent].
+static const CachedPowerOfTen &getCachedPowerOfTen(int E) {
+  // 1 / lg(10)
+  const double InvLog2Of10 = 0.30102999566398114;
+  int MinExponent = MinTargetExponent - (E + 64);
+  int K = int(std::ceil((MinExponent + 63) * InvLog2Of10));
+  unsigned Index = (K - CachedPowersMinDecimalExponent - 1) /
+                       CachedPowersDecimalExponentStep + 1;
+  const CachedPowerOfTen &Power = CachedPowersOfTen[Index];
+  assert(MinTargetExponent <= E + Power.BinaryExponent + 64 &&
+         E + Power.BinaryExponent + 64 <= MaxTargetExponent &&
+         "cached power of ten out of range");
+  return Power;
+}
+
+/// Decrements the last generated digit while that moves the result closer to
+/// the scaled value without leaving the rounding interval. Returns false if
+/// the imprecision of the scaled values means the result might not be the
+/// closest shortest representation.
+///
+/// \param DistanceTooHighW The distance from the upper bound of the unsafe
+///   interval to the scaled value, in units of the last digit's scale.
+/// \param UnsafeInterval The width of the interval that is guaranteed to
+///   contain the rounding interval.
+/// \param Rest The distance from the generated digits to the upper bound.
+/// \param TenKappa The weight of the last generated digit.
+/// \param Unit The maximal error of the scaled values.
+static bool roundWeed(char *Digits, int NumDigits, uint64_t DistanceTooHighW,
+                      uint64_t UnsafeInterval, uint64_t Rest,
+                      uint64_t TenKappa, uint64_t Unit) {
+  uint64_t SmallDistance = DistanceTooHighW - Unit;
+  uint64_t BigDistance = DistanceTooHighW + Unit;
+  while (Rest < SmallDistance && UnsafeInterval - Rest >= TenKappa &&
+         (Rest + TenKappa < SmallDistance ||
+          SmallDistance - Rest >= Rest + TenKappa - SmallDistance)) {
+    --Digits[NumDigits - 1];
+    Rest += TenKappa;
+  }
+
+  // If decrementing once more would be closer to the value when measured
+  // from the other end of the error range, we cannot tell which is right.
+  if (Rest < BigDistance && UnsafeInterval - Rest >= TenKappa &&
+      (Rest + TenKappa < BigDistance ||
+       BigDistance - Rest > Rest + TenKappa - BigDistance))
+    return false;
+
+  // The result must be safely inside the rounding interval.
+  return 2 * Unit <= Rest && Rest <= UnsafeInterval - 4 * Unit;
+}
+
+/// Generates the shortest digits within (Low, High) that are closest to W.
+/// All three values must share an exponent in [MinTargetExponent,
+/// MaxTargetExponent]. On success the digits represent
+/// Digits * 10^Kappa.
+static bool generateShortestDigits(DiyFp Low, DiyFp W, DiyFp High,
+                                   char *Digits, int &NumDigits, int &Kappa) {
+  // Low, W and High are each off by less than one unit, so widen the interval
+  // to one that certainly contains the real rounding interval.
+  uint64_t Unit = 1;
+  uint64_t TooLow = Low.F - Unit;
+  uint64_t TooHigh = High.F + Unit;
+  uint64_t UnsafeInterval = TooHigh - TooLow;
+
+  unsigned OneShift = -W.E;
+  uint64_t One = uint64_t(1) << OneShift;
+  uint32_t Integrals = uint32_t(TooHigh >> OneShift);
+  uint64_t Fractionals = TooHigh & (One - 1);
+
+  uint64_t Divisor = 1;
+  Kappa = 0;
+  while (Divisor <= Integrals) {
+    Divisor *= 10;
+    ++Kappa;
+  }
+  Divisor /= 10;
+
+  NumDigits = 0;
+  while (Kappa > 0) {
+    Digits[NumDigits++] = char('0' + Integrals / Divisor);
+    Integrals %= Divisor;
+    --Kappa;
+    uint64_t Rest = (uint64_t(Integrals) << OneShift) + Fractionals;
+    if (Rest < UnsafeInterval)
+      return roundWeed(Digits, NumDigits, TooHigh - W.F, UnsafeInterval, Rest,
+                       Divisor << OneShift, Unit);
+    Divisor /= 10;
+  }
+
+  while (true) {
+    Fractionals *= 10;
+    Unit *= 10;
+    UnsafeInterval *= 10;
+    Digits[NumDigits++] = char('0' + (Fractionals >> OneShift));
+    Fractionals &= One - 1;
+    --Kappa;
+    if (Fractionals < UnsafeInterval)
+      return roundWeed(Digits, NumDigits, (TooHigh - W.F) * Unit,
+                       UnsafeInterval, Fractionals, One, Unit);
+  }
+}
+
+template <typename T> struct FloatingPointLayout;
+
+template <> struct FloatingPointLayout<float> {
+  typedef uint32_t Bits;
+  static const int SignificandBits = 23;
+  static const int ExponentBias = 127;
+  static const int ExponentMask = 0xFF;
+  static const int MaxExactPowerOfTen = 10;
+};
+
+template <> struct FloatingPointLayout<double> {
+  typedef uint64_t Bits;
+  static const int SignificandBits = 52;
+  static const int ExponentBias = 1023;
+  static const int ExponentMask = 0x7FF;
+  static const int MaxExactPowerOfTen = 22;
+};
+
+/// Computes the shortest digits for a finite, positive \p Value with Grisu3.
+/// On success, the value reads back from Digits * 10^DecimalExponent.
+template <typename T>
+static bool grisuShortestDigits(T Value, char *Digits, int &NumDigits,
+                                int &DecimalExponent) {
+  typedef FloatingPointLayout<T> Layout;
+  typename Layout::Bits Bits;
+  memcpy(&Bits, &Value, sizeof(Bits));
+
+  const uint64_t HiddenBit = uint64_t(1) << Layout::SignificandBits;
+  uint64_t Fraction = Bits & (HiddenBit - 1);
+  int BiasedExponent = int(Bits >> Layout::SignificandBits) &
+                       Layout::ExponentMask;
+  DiyFp V;
+  if (BiasedExponent == 0)
+    V = {Fraction, 1 - Layout::ExponentBias - Layout::SignificandBits};
+  else
+    V = {Fraction | HiddenBit,
+         BiasedExponent - Layout::ExponentBias - Layout::SignificandBits};
+
+  // The rounding interval is bounded by the midpoints to the neighboring
+  // values. The lower neighbor is closer when V is a power of two.
+  DiyFp High = normalizeDiyFp({(V.F << 1) + 1, V.E - 1});
+  DiyFp Low;
+  if (Fraction == 0 && BiasedExponent > 1)
+    Low = {(V.F << 2) - 1, V.E - 2};
+  else
+    Low = {(V.F << 1) - 1, V.E - 1};
+  Low.F <<= Low.E - High.E;
+  Low.E = High.E;
+  DiyFp W = normalizeDiyFp(V);
+
+  const CachedPowerOfTen &Power = getCachedPowerOfTen(W.E);
+  DiyFp TenMK = {Power.Significand, Power.BinaryExponent};
+  int Kappa;
+  if (!generateShortestDigits(multiplyDiyFp(Low, TenMK),
+                              multiplyDiyFp(W, TenMK),
+                              multiplyDiyFp(High, TenMK),
+                              Digits, NumDigits, Kappa))
+    return false;
+  DecimalExponent = Kappa - Power.DecimalExponent;
+  return true;
+}
+
+static float swift_strtoFloatingPoint_l(const char *Str, float) {
+  return strtof_l(Str, nullptr, getCLocale());
+}
+
+static double swift_strtoFloatingPoint_l(const char *Str, double) {
+  return strtod_l(Str, nullptr, getCLocale());
+}
+
+/// Computes the shortest digits for a finite, positive \p Value by printing
+/// it with increasing precision until the result reads back exactly.
+template <typename T>
+static void slowShortestDigits(T Value, char *Digits, int &NumDigits,
+                               int &DecimalExponent) {
+  char Scratch[32];
+  for (int Precision = 1;; ++Precision) {
+    swift_snprintf_l(Scratch, sizeof(Scratch), /*locale=*/nullptr, "%.*e",
+                     Precision - 1, double(Value));
+    if (Precision == std::numeric_limits<T>::max_digits10 ||
+        swift_strtoFloatingPoint_l(Scratch, T()) == Value)
+      break;
+  }
+
+  // Scratch has the form "d.ddde[+-]xx".
+  NumDigits = 0;
+  const char *P = Scratch;
+  for (; *P != 'e'; ++P)
+    if (*P != '.')
+      Digits[NumDigits++] = *P;
+  DecimalExponent = atoi(P + 1) - (NumDigits - 1);
+}
+
+/// Formats Digits * 10^DecimalExponent like "%g" with a precision of
+/// digits10 would, but without dropping digits, and with ".0" appended to
+/// integral values.
+template <typename T>
+static uint64_t formatDecimalDigits(char *Buffer, bool Negative,
+                                    const char *Digits, int NumDigits,
+                                    int DecimalExponent) {
+  char *P = Buffer;
+  if (Negative)
+    *P++ = '-';
+
+  int Exponent = NumDigits + DecimalExponent - 1;
+  if (Exponent < -4 || Exponent >= std::numeric_limits<T>::digits10) {
+    *P++ = Digits[0];
+    if (NumDigits > 1) {
+      *P++ = '.';
+      memcpy(P, Digits + 1, NumDigits - 1);
+      P += NumDigits - 1;
+    }
+    *P++ = 'e';
+    *P++ = Exponent < 0 ? '-' : '+';
+    unsigned AbsExponent = Exponent < 0 ? -Exponent : Exponent;
+    if (AbsExponent >= 100)
+      *P++ = char('0' + AbsExponent / 100);
+    *P++ = char('0' + AbsExponent / 10 % 10);
+    *P++ = char('0' + AbsExponent % 10);
+  } else if (Exponent < 0) {
+    *P++ = '0';
+    *P++ = '.';
+    for (int i = -1; i > Exponent; --i)
+      *P++ = '0';
+    memcpy(P, Digits, NumDigits);
+    P += NumDigits;
+  } else {
+    int NumIntegralDigits = Exponent + 1;
+    for (int i = 0; i != NumIntegralDigits; ++i)
+      *P++ = i < NumDigits ? Digits[i] : '0';
+    *P++ = '.';
+    if (NumDigits > NumIntegralDigits) {
+      memcpy(P, Digits + NumIntegralDigits, NumDigits - NumIntegralDigits);
+      P += NumDigits - NumIntegralDigits;
+    } else {
+      *P++ = '0';
+    }
+  }
+  return P - Buffer;
+}
+
+template <typename T>
+static uint64_t swift_shortestFloatingPointToString(char *Buffer,
+                                                    size_t BufferLength,
+                                                    T Value) {
+  if (BufferLength < 32)
+    swift::crash("swift_floatingPointToString: insufficient buffer size");
+
+  if (std::isnan(Value)) {
+    memcpy(Buffer, "nan", 3);
+    return 3;
+  }
+
+  bool Negative = std::signbit(Value);
+  if (Negative)
+    Value = -Value;
+
+  if (std::isinf(Value)) {
+    if (Negative) {
+      memcpy(Buffer, "-inf", 4);
+      return 4;
+    }
+    memcpy(Buffer, "inf", 3);
+    return 3;
+  }
+
+  char Digits[24];
+  int NumDigits;
+  int DecimalExponent;
+  if (Value == 0) {
+    Digits[0] = '0';
+    NumDigits = 1;
+    DecimalExponent = 0;
+  } else if (!grisuShortestDigits(Value, Digits, NumDigits, DecimalExponent)) {
+    slowShortestDigits(Value, Digits, NumDigits, DecimalExponent);
+  }
+
+  return formatDecimalDigits<T>(Buffer, Negative, Digits, NumDigits,
+                                DecimalExponent);
+}
+
 extern "C" uint64_t swift_float32ToString(char *Buffer, size_t BufferLength,
                                           float Value) {
-  return swift_floatingPointToString<float>(Buffer, BufferLength, Value,
-                                            "%0.*g");
+  return swift_shortestFloatingPointToString<float>(Buffer, BufferLength,
+                                                    Value);
 }
 
 extern "C" uint64_t swift_float64ToString(char *Buffer, size_t BufferLength,
                                           double Value) {
-  return swift_floatingPointToString<double>(Buffer, BufferLength, Value,
-                                             "%0.*g");
+  return swift_shortestFloatingPointToString<double>(Buffer, BufferLength,
+                                                     Value);
 }
 
 extern "C" uint64_t swift_float80ToString(char *Buffer, size_t BufferLength,
@@ -297,6 +723,168 @@ extern "C" const char *_swift_stdlib_strtof_clocale(
     nptr, outResult, HUGE_VALF, strtof_l);
 }
 
+static bool isCLocaleSpace(char C) {
+  return C == ' ' || (C >= '\t' && C <= '\r');
+}
+
+static const double ExactPowersOfTen[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// Parses the decimal number [Str, End) when its value can be computed with
+/// a single correctly rounded multiplication or division of two exactly
+/// representable values (Clinger's fast path). Returns false if the text is
+/// not a plain decimal number or needs the full conversion.
+template <typename T>
+static bool parseExactDecimal(const char *Str, const char *End, T &Result) {
+  typedef FloatingPointLayout<T> Layout;
+  const char *P = Str;
+  bool Negative = false;
+  if (P != End && (*P == '+' || *P == '-')) {
+    Negative = *P == '-';
+    ++P;
+  }
+
+  // Accumulate up to 19 significant digits, which always fit in 64 bits.
+  uint64_t Mantissa = 0;
+  int NumDigits = 0;
+  int Exponent = 0;
+  bool SawDigit = false;
+  for (; P != End && *P >= '0' && *P <= '9'; ++P) {
+    SawDigit = true;
+    if (Mantissa == 0 && *P == '0')
+      continue;
+    if (NumDigits++ == 19)
+      return false;
+    Mantissa = Mantissa * 10 + (*P - '0');
+  }
+  if (P != End && *P == '.') {
+    for (++P; P != End && *P >= '0' && *P <= '9'; ++P) {
+      SawDigit = true;
+      --Exponent;
+      if (Mantissa == 0 && *P == '0')
+        continue;
+      if (NumDigits++ == 19)
+        return false;
+      Mantissa = Mantissa * 10 + (*P - '0');
+    }
+  }
+  if (!SawDigit)
+    return false;
+
+  if (P != End && (*P == 'e' || *P == 'E')) {
+    ++P;
+    bool NegativeExponent = false;
+    if (P != End && (*P == '+' || *P == '-')) {
+      NegativeExponent = *P == '-';
+      ++P;
+    }
+    if (P == End)
+      return false;
+    int ExplicitExponent = 0;
+    for (; P != End && *P >= '0' && *P <= '9'; ++P)
+      if (ExplicitExponent < 100000)
+        ExplicitExponent = ExplicitExponent * 10 + (*P - '0');
+    Exponent += NegativeExponent ? -ExplicitExponent : ExplicitExponent;
+  }
+  if (P != End)
+    return false;
+
+  if (Mantissa == 0) {
+    Result = Negative ? -T(0) : T(0);
+    return true;
+  }
+
+  const uint64_t MaxExactMantissa = uint64_t(1)
+                                    << (Layout::SignificandBits + 1);
+  if (Mantissa > MaxExactMantissa || Exponent < -Layout::MaxExactPowerOfTen)
+    return false;
+  // Values like "12e25" can still be exact if the excess power of ten fits
+  // into the mantissa.
+  for (; Exponent > Layout::MaxExactPowerOfTen; --Exponent) {
+    Mantissa *= 10;
+    if (Mantissa > MaxExactMantissa)
+      return false;
+  }
+
+  T Value = T(Mantissa);
+  if (Exponent < 0)
+    Value /= T(ExactPowersOfTen[-Exponent]);
+  else
+    Value *= T(ExactPowersOfTen[Exponent]);
+  Result = Negative ? -Value : Value;
+  return true;
+}
+
+template <typename T>
+static bool _swift_stdlib_parseX_ascii_impl(
+    const char *Str, size_t Length, T *outResult, T huge,
+    T (*posixImpl)(const char *, char **, locale_t)) {
+  if (Length == 0)
+    return false;
+  for (size_t i = 0; i != Length; ++i)
+    if (static_cast<unsigned char>(Str[i]) >= 0x80 || isCLocaleSpace(Str[i]))
+      return false;
+
+  if (parseExactDecimal(Str, Str + Length, *outResult))
+    return true;
+
+  // Everything else, including hexadecimal, "inf", "nan" and inexact
+  // decimals, goes through strto*_l, which needs a NUL-terminated copy.
+  char StackCopy[64];
+  char *Copy = Length < sizeof(StackCopy)
+                   ? StackCopy
+                   : static_cast<char *>(malloc(Length + 1));
+  memcpy(Copy, Str, Length);
+  Copy[Length] = '\0';
+  const char *EndPtr =
+      _swift_stdlib_strtoX_clocale_impl(Copy, outResult, huge, posixImpl);
+  bool Consumed = EndPtr == Copy + Length;
+  if (Copy != StackCopy)
+    free(Copy);
+  return Consumed;
+}
+
+extern "C" bool _swift_stdlib_parseDouble_ascii(
+    const char *Str, size_t Length, double *outResult) {
+  return _swift_stdlib_parseX_ascii_impl(Str, Length, outResult, HUGE_VAL,
+                                         strtod_l);
+}
+
+extern "C" bool _swift_stdlib_parseFloat_ascii(
+    const char *Str, size_t Length, float *outResult) {
+  return _swift_stdlib_parseX_ascii_impl(Str, Length, outResult, HUGE_VALF,
+                                         strtof_l);
+}
+
+extern "C" bool _swift_stdlib_parseUInt64_ascii(
+    const char *Str, size_t Length, intptr_t Radix, uint64_t Maximum,
+    uint64_t *outResult) {
+  if (Length == 0)
+    return false;
+
+  uint64_t Result = 0;
+  for (size_t i = 0; i != Length; ++i) {
+    char C = Str[i];
+    uint64_t Digit;
+    if (C >= '0' && C <= '9')
+      Digit = C - '0';
+    else if (C >= 'a' && C <= 'z')
+      Digit = C - 'a' + 10;
+    else if (C >= 'A' && C <= 'Z')
+      Digit = C - 'A' + 10;
+    else
+      return false;
+    if (Digit >= uint64_t(Radix) || Digit > Maximum ||
+        Result > (Maximum - Digit) / uint64_t(Radix))
+      return false;
+    Result = Result * Radix + Digit;
+  }
+  *outResult = Result;
+  return true;
+}
+
 extern "C" void _swift_stdlib_flockfile_stdout() {
   flockfile(stdout);
 }
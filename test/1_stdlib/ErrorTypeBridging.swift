@@ -286,4 +286,38 @@ ErrorTypeBridgingTests.test("Thrown NSError identity is preserved") {
   }
 }
 
+enum PlainError : ErrorType {
+  case First, Second
+}
+
+@inline(never)
+func throwPlainError(e: PlainError) throws {
+  throw e
+}
+
+@inline(never)
+func catchPlainErrorAsNSError(e: PlainError) -> NSError? {
+  do {
+    try throwPlainError(e)
+  } catch let ns as NSError {
+    return ns
+  } catch {
+    expectUnreachable()
+  }
+  return nil
+}
+
+ErrorTypeBridgingTests.test("Separate throws bridge to separate NSErrors") {
+  let first = catchPlainErrorAsNSError(.First)!
+  let second = catchPlainErrorAsNSError(.First)!
+  expectTrue(first !== second)
+
+  // State attached to one bridged error doesn't show up on the other.
+  objc_setAssociatedObject(first, &CanaryHandle, NoisyError(),
+                           .OBJC_ASSOCIATION_RETAIN_NONATOMIC)
+  expectTrue(objc_getAssociatedObject(second, &CanaryHandle) == nil)
+  expectEqual(first.domain, second.domain)
+  expectEqual(first.code, second.code)
+}
+
 runAllTests()
@@ -0,0 +1,102 @@
+// RUN: rm -rf %t  &&  mkdir %t
+// RUN: %target-build-swift %s -o %t/a.out
+// RUN: %target-run %t/a.out
+// RUN: %target-build-swift -O %s -o %t/a.out.optimized
+// RUN: %target-run %t/a.out.optimized
+// REQUIRES: executable_test
+
+// With ObjC interop, error boxes are NSErrors and are never shared; see
+// ErrorTypeBridging.swift.
+// UNSUPPORTED: objc_interop
+
+// Values of enums without payloads are thrown in shared, preallocated boxes.
+
+import StdlibUnittest
+
+enum SharedError : ErrorType {
+  case First, Second, Third
+}
+
+struct UnsharedError : ErrorType {
+  var code: Int
+}
+
+@inline(never)
+func throwShared(e: SharedError) throws {
+  throw e
+}
+
+@inline(never)
+func throwUnshared(code: Int) throws {
+  throw UnsharedError(code: code)
+}
+
+@inline(never)
+func catchError(body: () throws -> ()) -> ErrorType? {
+  do {
+    try body()
+  } catch {
+    return error
+  }
+  return nil
+}
+
+/// The address of the box holding \p e.
+func boxAddress(e: ErrorType) -> UnsafePointer<Void> {
+  return unsafeBitCast(e, UnsafePointer<Void>.self)
+}
+
+func expectShared(expected: SharedError, _ e: ErrorType?) {
+  if let shared = e as? SharedError {
+    expectEqual(expected, shared)
+  } else {
+    expectUnreachable("expected \(expected), got \(e)")
+  }
+}
+
+var ErrorTypeSharedBoxesTests = TestSuite("ErrorTypeSharedBoxes")
+
+ErrorTypeSharedBoxesTests.test("repeated throws share a box") {
+  let first = catchError { try throwShared(.Second) }!
+  let second = catchError { try throwShared(.Second) }!
+  let third = catchError { try throwShared(.Second) }!
+  expectEqual(boxAddress(first), boxAddress(second))
+  expectEqual(boxAddress(first), boxAddress(third))
+  expectShared(.Second, third)
+
+  // Other values of the same type have boxes of their own.
+  let other = catchError { try throwShared(.Third) }!
+  expectNotEqual(boxAddress(first), boxAddress(other))
+  expectShared(.Third, other)
+  expectShared(.Second, first)
+}
+
+ErrorTypeSharedBoxesTests.test("shared boxes are never freed or changed") {
+  var address: UnsafePointer<Void> = nil
+  do {
+    let e = catchError { try throwShared(.First) }!
+    address = boxAddress(e)
+  }
+
+  // Every reference from a catch has been released. The box must still be
+  // alive and hold the same value, rather than being freed and reused.
+  for _ in 0..<1000 {
+    _ = catchError { try throwShared(.Third) }
+    _ = catchError { try throwUnshared(1) }
+  }
+  for _ in 0..<1000 {
+    let e = catchError { try throwShared(.First) }
+    expectEqual(address, boxAddress(e!))
+    expectShared(.First, e)
+  }
+}
+
+ErrorTypeSharedBoxesTests.test("other errors are not shared") {
+  let first = catchError { try throwUnshared(1) }!
+  let second = catchError { try throwUnshared(1) }!
+  expectNotEqual(boxAddress(first), boxAddress(second))
+  expectEqual(1, (first as! UnsharedError).code)
+  expectEqual(1, (second as! UnsharedError).code)
+}
+
+runAllTests()
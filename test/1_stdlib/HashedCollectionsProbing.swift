@@ -0,0 +1,319 @@
+// RUN: mkdir -p %t
+// RUN: %target-build-swift %s -o %t/a.out
+//
+// RUN: %target-run %t/a.out
+// REQUIRES: executable_test
+
+// Checks lookups, insertion and removal in the native Dictionary and Set
+// storage in the cases that stress the control-byte probing: tables with only
+// a couple of buckets, clusters that run past the last bucket into the
+// mirrored control bytes, and long sequences of removals and reinsertions.
+
+import StdlibUnittest
+
+// Also import modules which are used by StdlibUnittest internally. This
+// workaround is needed to link all required libraries in case we compile
+// StdlibUnittest with -sil-serialize-all.
+import SwiftPrivate
+#if _runtime(_ObjC)
+import ObjectiveC
+#endif
+
+/// A key whose hash value is chosen by the test, so that many distinct keys
+/// can share a bucket and a tag.
+struct CollidingKey : Hashable {
+  var value: Int
+  var hashValue: Int
+
+  init(_ value: Int, hashValue: Int) {
+    self.value = value
+    self.hashValue = hashValue
+  }
+}
+
+func == (lhs: CollidingKey, rhs: CollidingKey) -> Bool {
+  return lhs.value == rhs.value
+}
+
+/// A key that collides with every other key.
+func allColliding(value: Int) -> CollidingKey {
+  return CollidingKey(value, hashValue: 0)
+}
+
+/// A key that collides with one in eight other keys.
+func fewClusters(value: Int) -> CollidingKey {
+  return CollidingKey(value, hashValue: value % 8)
+}
+
+/// A deterministic pseudo-random sequence, so that failures reproduce.
+struct LinearCongruentialGenerator {
+  var state: UInt64
+
+  init(seed: UInt64) {
+    state = seed
+  }
+
+  mutating func next(upperBound: Int) -> Int {
+    state = state &* 6364136223846793005 &+ 1442695040888963407
+    return Int(truncatingBitPattern: state >> 33) % upperBound
+  }
+}
+
+/// Checks `d` against `model`, which holds the expected key/value pairs in no
+/// particular order, and checks that each of `absent` misses.
+func expectDictionaryMatchesModel(
+  d: [CollidingKey : Int],
+  _ model: [(CollidingKey, Int)],
+  absent: [CollidingKey],
+  stackTrace: SourceLocStack = SourceLocStack(),
+  file: String = __FILE__, line: UInt = __LINE__
+) {
+  let newTrace = stackTrace.pushIf(true, file: file, line: line)
+  expectEqual(model.count, d.count, stackTrace: newTrace)
+  for (key, value) in model {
+    expectOptionalEqual(value, d[key], stackTrace: newTrace)
+    expectNotEmpty(d.indexForKey(key), stackTrace: newTrace)
+  }
+  for key in absent {
+    expectEmpty(d[key], stackTrace: newTrace)
+    expectEmpty(d.indexForKey(key), stackTrace: newTrace)
+  }
+  var iterated = 0
+  for (key, value) in d {
+    expectTrue(model.contains { $0.0 == key && $0.1 == value },
+      stackTrace: newTrace)
+    iterated += 1
+  }
+  expectEqual(model.count, iterated, stackTrace: newTrace)
+}
+
+/// Checks `s` against `model`, and checks that each of `absent` misses.
+func expectSetMatchesModel(
+  s: Set<CollidingKey>,
+  _ model: [CollidingKey],
+  absent: [CollidingKey],
+  stackTrace: SourceLocStack = SourceLocStack(),
+  file: String = __FILE__, line: UInt = __LINE__
+) {
+  let newTrace = stackTrace.pushIf(true, file: file, line: line)
+  expectEqual(model.count, s.count, stackTrace: newTrace)
+  for key in model {
+    expectTrue(s.contains(key), stackTrace: newTrace)
+  }
+  for key in absent {
+    expectFalse(s.contains(key), stackTrace: newTrace)
+  }
+  var iterated = 0
+  for key in s {
+    expectTrue(model.contains(key), stackTrace: newTrace)
+    iterated += 1
+  }
+  expectEqual(model.count, iterated, stackTrace: newTrace)
+}
+
+var HashedCollectionsProbing = TestSuite("HashedCollectionsProbing")
+
+HashedCollectionsProbing.test("Dictionary/TinyCapacity") {
+  for minimumCapacity in 0...3 {
+    for makeKey in [allColliding, fewClusters] {
+      var d = [CollidingKey : Int](minimumCapacity: minimumCapacity)
+      expectEmpty(d[makeKey(0)])
+
+      var model: [(CollidingKey, Int)] = []
+      for i in 0..<4 {
+        expectEmpty(d.updateValue(i * 10, forKey: makeKey(i)))
+        model.append((makeKey(i), i * 10))
+        expectDictionaryMatchesModel(d, model, absent: [makeKey(100)])
+      }
+      for i in 0..<4 {
+        expectOptionalEqual(i * 10, d.removeValueForKey(makeKey(i)))
+        model.removeFirst()
+        expectDictionaryMatchesModel(d, model, absent: [makeKey(i)])
+      }
+    }
+  }
+}
+
+HashedCollectionsProbing.test("Set/TinyCapacity") {
+  for minimumCapacity in 0...3 {
+    for makeKey in [allColliding, fewClusters] {
+      var s = Set<CollidingKey>(minimumCapacity: minimumCapacity)
+      expectFalse(s.contains(makeKey(0)))
+
+      var model: [CollidingKey] = []
+      for i in 0..<4 {
+        expectFalse(s.contains(makeKey(i)))
+        s.insert(makeKey(i))
+        model.append(makeKey(i))
+        expectSetMatchesModel(s, model, absent: [makeKey(100)])
+      }
+      for i in 0..<4 {
+        expectOptionalEqual(makeKey(i), s.remove(makeKey(i)))
+        model.removeFirst()
+        expectSetMatchesModel(s, model, absent: [makeKey(i)])
+      }
+    }
+  }
+}
+
+HashedCollectionsProbing.test("Dictionary/Wraparound") {
+  // All keys share one hash value, so they probe from the same bucket and
+  // form a single cluster covering most of the table once it's filled to
+  // its maximum load.  Whenever that bucket is past the first quarter of the
+  // table the cluster runs past the last bucket; trying several hash values
+  // gets a number of starting buckets for every table size the dictionary
+  // grows through.
+  for sharedHash in 0..<8 {
+    for count in [ 3, 7, 12, 13, 24, 25, 48, 49, 96, 97 ] {
+      let makeKey = { (value: Int) in
+        CollidingKey(value, hashValue: sharedHash)
+      }
+      var d = [CollidingKey : Int]()
+      var model: [(CollidingKey, Int)] = []
+      for i in (0..<count).reverse() {
+        d[makeKey(i)] = -i
+        model.append((makeKey(i), -i))
+      }
+      expectDictionaryMatchesModel(
+        d, model, absent: [makeKey(-1), makeKey(count)])
+
+      // Remove every other key, so that the backward shift moves entries
+      // across the end of the table, then check that the rest are still
+      // found.
+      for i in 0.stride(to: count, by: 2) {
+        expectOptionalEqual(-i, d.removeValueForKey(makeKey(i)))
+      }
+      model = model.filter { $0.0.value % 2 != 0 }
+      expectDictionaryMatchesModel(
+        d, model, absent: [makeKey(0), makeKey(count)])
+    }
+  }
+}
+
+HashedCollectionsProbing.test("Set/Wraparound") {
+  for sharedHash in 0..<8 {
+    for count in [ 3, 7, 12, 13, 24, 25, 48, 49, 96, 97 ] {
+      let makeKey = { (value: Int) in
+        CollidingKey(value, hashValue: sharedHash)
+      }
+      var s = Set<CollidingKey>()
+      var model: [CollidingKey] = []
+      for i in (0..<count).reverse() {
+        s.insert(makeKey(i))
+        model.append(makeKey(i))
+      }
+      expectSetMatchesModel(s, model, absent: [makeKey(-1), makeKey(count)])
+
+      for i in 0.stride(to: count, by: 2) {
+        expectOptionalEqual(makeKey(i), s.remove(makeKey(i)))
+      }
+      model = model.filter { $0.value % 2 != 0 }
+      expectSetMatchesModel(s, model, absent: [makeKey(0), makeKey(count)])
+    }
+  }
+}
+
+HashedCollectionsProbing.test("Dictionary/Wraparound/FullCapacity") {
+  // Fill a table created with a fixed capacity up to its maximum load, using
+  // keys spread over a few clusters that run into each other.
+  for capacity in [ 16, 32, 64 ] {
+    var d = [CollidingKey : Int](minimumCapacity: capacity)
+    var model: [(CollidingKey, Int)] = []
+    for i in 0..<(capacity * 3 / 4) {
+      d[fewClusters(i)] = i
+      model.append((fewClusters(i), i))
+      expectOptionalEqual(i, d[fewClusters(i)])
+    }
+    expectDictionaryMatchesModel(
+      d, model, absent: (capacity..<(capacity + 8)).map(fewClusters))
+  }
+}
+
+HashedCollectionsProbing.test("Dictionary/RemoveReinsertChurn") {
+  for makeKey in [allColliding, fewClusters] {
+    var generator = LinearCongruentialGenerator(seed: 42)
+    var d = [CollidingKey : Int]()
+    var model: [(CollidingKey, Int)] = []
+    let keyRange = 48
+
+    for step in 0..<2000 {
+      let key = makeKey(generator.next(keyRange))
+      let modelIndex = model.indexOf { $0.0 == key }
+      if generator.next(3) == 0 {
+        let removed = d.removeValueForKey(key)
+        if let modelIndex = modelIndex {
+          expectOptionalEqual(model[modelIndex].1, removed)
+          model.removeAtIndex(modelIndex)
+        } else {
+          expectEmpty(removed)
+        }
+      } else {
+        let old = d.updateValue(step, forKey: key)
+        if let modelIndex = modelIndex {
+          expectOptionalEqual(model[modelIndex].1, old)
+          model[modelIndex].1 = step
+        } else {
+          expectEmpty(old)
+          model.append((key, step))
+        }
+      }
+      expectEqual(model.count, d.count)
+      if step % 50 == 0 {
+        let absent = (0..<keyRange).map(makeKey).filter { key in
+          !model.contains { $0.0 == key }
+        }
+        expectDictionaryMatchesModel(d, model, absent: absent)
+      }
+    }
+
+    // Drain the dictionary completely, then fill it again.
+    for (key, _) in model {
+      expectNotEmpty(d.removeValueForKey(key))
+    }
+    expectEqual(0, d.count)
+    expectDictionaryMatchesModel(
+      d, [], absent: (0..<keyRange).map(makeKey))
+    model = (0..<keyRange).map { (makeKey($0), $0) }
+    for (key, value) in model {
+      d[key] = value
+    }
+    expectDictionaryMatchesModel(d, model, absent: [makeKey(keyRange)])
+  }
+}
+
+HashedCollectionsProbing.test("Set/RemoveReinsertChurn") {
+  for makeKey in [allColliding, fewClusters] {
+    var generator = LinearCongruentialGenerator(seed: 7)
+    var s = Set<CollidingKey>()
+    var model: [CollidingKey] = []
+    let keyRange = 48
+
+    for step in 0..<2000 {
+      let key = makeKey(generator.next(keyRange))
+      let modelIndex = model.indexOf(key)
+      if generator.next(2) == 0 {
+        let removed = s.remove(key)
+        if let modelIndex = modelIndex {
+          expectOptionalEqual(key, removed)
+          model.removeAtIndex(modelIndex)
+        } else {
+          expectEmpty(removed)
+        }
+      } else {
+        s.insert(key)
+        if modelIndex == nil {
+          model.append(key)
+        }
+      }
+      expectEqual(model.count, s.count)
+      if step % 50 == 0 {
+        let absent = (0..<keyRange).map(makeKey).filter {
+          !model.contains($0)
+        }
+        expectSetMatchesModel(s, model, absent: absent)
+      }
+    }
+  }
+}
+
+runAllTests()
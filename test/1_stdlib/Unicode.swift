@@ -44,3 +44,60 @@ UnicodeInternals.test("copy") {
   }
 }
 
+
+var UnicodeBulkTranscoding = TestSuite("UnicodeBulkTranscoding")
+
+// Long enough that the runtime's bulk routines see full 16-byte runs of
+// ASCII on either side of the multi-byte sequences.
+let bulkTranscodingSamples: [String] = [
+  "",
+  "a",
+  "the quick brown fox jumps over the lazy dog",
+  "the quick brown fox — jumps over the lazy dog",
+  "абвгдеёжзийклмнопрстуфхцчшщъыьэюя",
+  "0123456789abcdef\u{10FFFF}0123456789abcdef\u{1F600}",
+  "\u{E9}\u{800}\u{FFFF}\u{10000}0123456789abcdef0123456789abcdef",
+]
+
+UnicodeBulkTranscoding.test("fromCString") {
+  for sample in bulkTranscodingSamples {
+    sample.nulTerminatedUTF8.withUnsafeBufferPointer {
+      expectOptionalEqual(
+        sample, String.fromCString(UnsafePointer($0.baseAddress)))
+    }
+  }
+}
+
+UnicodeBulkTranscoding.test("fromCString/IllFormed") {
+  let prefix: [UInt8] = Array("0123456789abcdef0123456789abcdef".utf8)
+  let illFormed: [[UInt8]] = [
+    [ 0x80 ],                   // lone continuation byte
+    [ 0xc0, 0x80 ],             // overlong 2-byte sequence
+    [ 0xe0, 0x80, 0x80 ],       // overlong 3-byte sequence
+    [ 0xed, 0xa0, 0x80 ],       // encoded surrogate
+    [ 0xf4, 0x90, 0x80, 0x80 ], // above U+10FFFF
+    [ 0xe2, 0x80 ],             // truncated sequence
+  ]
+  for bytes in illFormed {
+    let cString = (prefix + bytes + [ 0 ]).map { CChar(bitPattern: $0) }
+    cString.withUnsafeBufferPointer {
+      expectEmpty(String.fromCString($0.baseAddress))
+
+      let (result, hadError) =
+        String.fromCStringRepairingIllFormedUTF8($0.baseAddress)
+      expectTrue(hadError)
+      expectOptionalEqual(
+        String._fromCodeUnitSequenceWithRepair(
+          UTF8.self, input: prefix + bytes).0,
+        result)
+    }
+  }
+}
+
+UnicodeBulkTranscoding.test("nulTerminatedUTF8") {
+  for sample in bulkTranscodingSamples {
+    expectEqual(Array(sample.utf8) + [ 0 ], Array(sample.nulTerminatedUTF8))
+  }
+}
+
+runAllTests()
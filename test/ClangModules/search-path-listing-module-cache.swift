@@ -0,0 +1,22 @@
+// REQUIRES: asserts
+
+// Clang builds modules into the module cache during the job. When the module
+// cache is inside an import search path, the listing of that search path
+// taken beforehand must not hide the modules Clang has just built.
+//
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/build
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -parse -verify %s -I %t/build -I %S/Inputs/custom-modules -module-cache-path %t/build/ModuleCache -print-stats 2>&1 | FileCheck %s
+// RUN: ls %t/build/ModuleCache/*/ExternIntX-*.pcm
+
+// Later jobs list the module cache as part of the search path, and still find
+// the modules built before.
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -parse -verify %s -I %t/build -I %S/Inputs/custom-modules -module-cache-path %t/build/ModuleCache
+
+// CHECK: Statistics Collected
+// CHECK-DAG: {{[1-9][0-9]*}} Clang module importer - # of file system stats by Clang
+// CHECK-DAG: {{[1-9][0-9]*}} Clang module importer - # of Clang file system stats avoided using directory listings
+
+import ExternIntX
+
+x += 1
@@ -14,3 +14,14 @@ func f1(a: A) -> A { return a }
 func f1(b: B) -> B { return b }
 
 f0(f1(B()))
+
+// Many viable solutions that differ only in which overload of g they pick.
+func g(x: Int) -> Int { return x }
+func g(x: Double) -> Double { return x }
+func g<T>(x: T) -> T { return x }
+
+let r0 = g(1) + g(2) + g(3) + g(4) + g(5) + g(6)
+let _: String = r0 // expected-error{{cannot convert value of type 'Int' to specified type 'String'}}
+
+let r1 = g(1) + g(2.5) + g(3) + g(4)
+let _: String = r1 // expected-error{{cannot convert value of type 'Double' to specified type 'String'}}
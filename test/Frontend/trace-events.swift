@@ -0,0 +1,16 @@
+// RUN: rm -rf %t && mkdir %t
+// RUN: %target-swift-frontend -emit-sil %s -trace-events-path %t/trace.json -o /dev/null
+// RUN: FileCheck %s < %t/trace.json
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: {"name":"Parsing","cat":"frontend","ph":"X","pid":1,"tid":{{[0-9]+}},"ts":{{[0-9]+\.[0-9]+}},"dur":{{[0-9]+\.[0-9]+}}}
+// CHECK-DAG: "name":"Name binding"
+// CHECK-DAG: "name":"Type checking"
+// CHECK-DAG: "name":"SILGen"
+// CHECK-DAG: "name":"SIL diagnostic passes"
+// CHECK: ],"displayTimeUnit":"ms"}
+
+// RUN: not %target-swift-frontend -parse %s -trace-events-path %t/missing/trace.json 2>&1 | FileCheck -check-prefix=ERROR %s
+// ERROR: error: error opening '{{.*}}trace.json' for output
+
+func f() -> Int { return 1 }
@@ -0,0 +1,31 @@
+// RUN: rm -rf %t && mkdir %t
+// RUN: %target-build-swift %s -o %t/a.out
+// RUN: env SWIFT_HEAP_PROFILE=%t/heap SWIFT_HEAP_PROFILE_RATE=1 %target-run %t/a.out | FileCheck -check-prefix=OUTPUT %s
+// RUN: FileCheck -check-prefix=PROFILE %s < %t/heap
+// RUN: FileCheck -check-prefix=TYPES %s < %t/heap.types
+// REQUIRES: executable_test
+// REQUIRES: OS=linux-gnu
+
+// With a rate of 1 byte, every allocation is sampled.
+
+class Retained {
+  var payload = (0, 0, 0, 0)
+}
+
+class Released {
+  var payload = 0
+}
+
+var retained = [Retained]()
+for _ in 0..<100 {
+  retained.append(Retained())
+  _ = Released()
+}
+// OUTPUT: 100
+print(retained.count)
+
+// PROFILE: heap profile: {{ *[0-9]+: *[0-9]+ \[ *[0-9]+: *[0-9]+\]}} @ heap_v2/1
+// PROFILE: MAPPED_LIBRARIES:
+
+// TYPES-DAG: {{^ *}}100: {{ *[0-9]+}} [   100: {{ *[0-9]+}}] heap_profiler.Retained
+// TYPES-DAG: {{^ *}}0: {{ *0}} [   100: {{ *[0-9]+}}] heap_profiler.Released
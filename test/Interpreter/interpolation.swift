@@ -19,3 +19,13 @@ var someval = 0xFFeeFF0033
 print("value = \(someval)")
 
 
+
+// CHECK: 1 + 2 = 3, α + β = γ
+var alpha = "α"
+print("\(1) + \(2) = \(3), \(alpha) + β = \("γ")")
+
+// CHECK: [only]
+var only = "only"
+print("[\(only)]")
+// CHECK: only
+print("\(only)")
@@ -0,0 +1,60 @@
+// RUN: rm -rf %t  &&  mkdir %t
+// RUN: %target-build-swift %s -o %t/a.out
+// RUN: %target-run %t/a.out | FileCheck %s
+// RUN: %target-build-swift -O %s -o %t/a.out.optimized
+// RUN: %target-run %t/a.out.optimized | FileCheck %s
+// REQUIRES: executable_test
+
+func keyword(s: String) -> String {
+  switch s {
+  case "class": return "class"
+  case "struct": return "struct"
+  case "enum": return "enum"
+  case "protocol": return "protocol"
+  case "extension", "func": return "extension/func"
+  case "K": return "K"
+  case "": return "empty"
+  default: return "default"
+  }
+}
+
+func duplicate(s: String) -> Int {
+  switch s {
+  case "a": return 0
+  case "b": return 1
+  case "a": return 2
+  case "c": return 3
+  default: return -1
+  }
+}
+
+// CHECK: class
+print(keyword("class"))
+// CHECK: protocol
+print(keyword("protocol"))
+// CHECK: extension/func
+print(keyword("func"))
+// CHECK: empty
+print(keyword(""))
+// CHECK: default
+print(keyword("classy"))
+// CHECK: default
+print(keyword("Class"))
+
+// ASCII subjects with UTF-16 storage still match.
+// CHECK: struct
+print(keyword(String("\u{e9}struct".characters.dropFirst())))
+
+// KELVIN SIGN is canonically equivalent to "K", and must still match.
+// CHECK: K
+print(keyword("\u{212A}"))
+
+// A non-ASCII subject that matches nothing.
+// CHECK: default
+print(keyword("\u{e9}num"))
+
+// The first of several identical labels wins.
+// CHECK: 0
+print(duplicate("a"))
+// CHECK: 3
+print(duplicate("c"))
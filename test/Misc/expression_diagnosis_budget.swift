@@ -0,0 +1,17 @@
+// RUN: %target-parse-verify-swift -solver-diagnosis-recheck-limit 0
+// RUN: not %target-swift-frontend -parse -debug-time-expression-diagnosis %s 2>&1 | FileCheck %s
+
+// A limit that is reached after some sub-expressions were re-type-checked
+// still ends in the expression being reported as too complex.
+// RUN: not %target-swift-frontend -parse -solver-diagnosis-recheck-limit 1 -debug-time-expression-diagnosis %s 2>&1 | FileCheck -check-prefix=PARTIAL %s
+
+func f(x: Int) -> Int { return x }
+
+// CHECK: {{[0-9.]+}}ms{{.*}}expression_diagnosis_budget.swift:[[@LINE+3]]:{{[0-9]+}}{{.*}} re-type-checks
+// PARTIAL: expression_diagnosis_budget.swift:[[@LINE+2]]:{{[0-9]+}}: error: expression was too complex to be solved in reasonable time
+// PARTIAL: {{[0-9.]+}}ms{{.*}}expression_diagnosis_budget.swift:[[@LINE+1]]:{{[0-9]+}}{{.*}} 1 re-type-checks (budget exceeded)
+let a = f("one") + f(2) // expected-error{{expression was too complex to be solved in reasonable time; consider breaking up the expression into distinct sub-expressions}}
+
+// No errors should appear below as a result of the error above.
+// PARTIAL-NOT: error:
+let b = f(1) + f(2)
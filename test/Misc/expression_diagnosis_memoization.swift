@@ -0,0 +1,39 @@
+// Diagnosing an expression skips sub-expression re-type-checks that already
+// failed during the same diagnosis.  Check that doing so doesn't change which
+// diagnostics are emitted.
+// RUN: %target-parse-verify-swift
+// RUN: %target-parse-verify-swift -solver-disable-diagnosis-memoization
+
+func f(x: Int) -> Int { return x }
+
+var i: Int = 0
+var d: Double = 1.0
+
+infix operator **** {
+  associativity left
+  precedence 200
+}
+
+func ****(_: Int, _: String) { }
+i **** i // expected-error{{cannot convert value of type 'Int' to expected argument type 'String'}}
+
+f(d) // expected-error{{cannot convert value of type 'Double' to expected argument type 'Int'}}
+_ = f(f(f(d))) // expected-error{{cannot convert value of type 'Double' to expected argument type 'Int'}}
+
+func ternaries(i : Int) {
+  _ = i == 0 ? "" : i  // expected-error {{result values in '? :' expression have mismatching types 'String' and 'Int'}}
+  _ = true ? [i] : i // expected-error {{result values in '? :' expression have mismatching types '[Int]' and 'Int'}}
+}
+
+class CurriedClass {
+  func method1() {}
+  func method2(a: Int)(b : Int) {} // expected-warning{{curried function declaration syntax will be removed in a future version of Swift}}
+}
+
+let c = CurriedClass()
+c.method1(1)         // expected-error {{argument passed to call that takes no arguments}}
+_ = c.method2(1.0)   // expected-error {{cannot convert value of type 'Double' to expected argument type 'Int'}}
+c.method2(1)(c: 2.0) // expected-error {{incorrect argument label in call (have 'c:', expected 'b:')}}
+c.method2(1)(b: 2.0) // expected-error {{cannot convert value of type 'Double' to expected argument type 'Int'}}
+c.method2(1.0)(b: 2) // expected-error {{cannot convert value of type 'Double' to expected argument type 'Int'}}
+c.method2(1.0)(b: 2.0) // expected-error {{cannot convert value of type 'Double' to expected argument type 'Int'}}
@@ -0,0 +1,3 @@
+enum DerivedEnum {
+  case First, Second
+}
@@ -0,0 +1,3 @@
+func otherFileHelper(x: Int) -> Int { return x + 1 }
+
+let otherFileConstant: Int = 42
@@ -0,0 +1,14 @@
+// RUN: %target-swift-frontend -parse -verify -primary-file %s %S/Inputs/unqualified-lookup-cache-derived-other.swift
+
+// DerivedEnum's == is derived while the first function is type-checked,
+// after this file has cached the lookup of ==. Later lookups of == must
+// find the derived operator.
+
+func compareDirectly(a: DerivedEnum, _ b: DerivedEnum) -> Bool {
+  return a == b
+}
+
+func compareThroughFunctionValue() -> Bool {
+  let equals: (DerivedEnum, DerivedEnum) -> Bool = (==)
+  return equals(.First, .Second)
+}
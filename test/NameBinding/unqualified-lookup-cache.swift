@@ -0,0 +1,25 @@
+// REQUIRES: asserts
+
+// RUN: %target-swift-frontend -parse -primary-file %s %S/Inputs/unqualified-lookup-cache-other.swift -print-stats 2>&1 | FileCheck %s
+
+// CHECK: Statistics Collected
+// CHECK-DAG: {{[1-9][0-9]*}} Name lookup - # of top-level unqualified lookups found in the per-file cache
+// CHECK-DAG: {{[1-9][0-9]*}} Name lookup - # of top-level unqualified lookups added to the per-file cache
+
+func sum(a: Int, _ b: Int, _ c: Int) -> Int {
+  return otherFileHelper(a) + otherFileHelper(b) + otherFileHelper(c)
+}
+
+struct Local {
+  var x: Int
+  var y: Int
+  func scaled(by: Int) -> Local {
+    return Local(x: otherFileHelper(x) * by, y: otherFileHelper(y) * by)
+  }
+}
+
+// Names from this file and the other one are cached the same way.
+func useLocal() -> Int {
+  let l = Local(x: 1, y: 2).scaled(3)
+  return sum(l.x, l.y, otherFileConstant)
+}
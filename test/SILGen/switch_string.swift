@@ -0,0 +1,66 @@
+// RUN: %target-swift-frontend -emit-silgen %s | FileCheck %s
+
+// A long run of ASCII string literal cases is dispatched on a hash of the
+// subject, with the in-order '~=' chain kept for subjects that may not be
+// ASCII.
+
+// CHECK-LABEL: sil hidden @_TF13switch_string7keywordFSSSi
+// CHECK:         [[HASH_FN:%.*]] = function_ref @_TFs17_stringSwitchHashFSSVs5Int32
+// CHECK:         [[HASH:%.*]] = apply [[HASH_FN]](
+// CHECK:         [[BUILTIN_HASH:%.*]] = struct_extract [[HASH]] : $Int32, #Int32._value
+// CHECK:         switch_value [[BUILTIN_HASH]] : $Builtin.Int32, {{.*}}, default [[NO_MATCH:bb[0-9]+]]
+// CHECK:       [[NO_MATCH]]:
+// CHECK:       } // end sil function '_TF13switch_string7keywordFSSSi'
+func keyword(s: String) -> Int {
+  switch s {
+  case "class": return 0
+  case "struct": return 1
+  case "enum": return 2
+  case "protocol": return 3
+  case "extension", "func": return 4
+  default: return -1
+  }
+}
+
+// Short runs are still tested in order.
+// CHECK-LABEL: sil hidden @_TF13switch_string5shortFSSSi
+// CHECK-NOT:     _stringSwitchHash
+// CHECK:       } // end sil function '_TF13switch_string5shortFSSSi'
+func short(s: String) -> Int {
+  switch s {
+  case "let": return 0
+  case "var": return 1
+  case "inout": return 2
+  default: return -1
+  }
+}
+
+// A non-ASCII literal ends the run, since it can match a subject with
+// different code units.
+// CHECK-LABEL: sil hidden @_TF13switch_string8nonASCIIFSSSi
+// CHECK-NOT:     _stringSwitchHash
+// CHECK:       } // end sil function '_TF13switch_string8nonASCIIFSSSi'
+func nonASCII(s: String) -> Int {
+  switch s {
+  case "a": return 0
+  case "b": return 1
+  case "\u{212A}": return 2
+  case "c": return 3
+  case "d": return 4
+  default: return -1
+  }
+}
+
+// Guards end the run.
+// CHECK-LABEL: sil hidden @_TF13switch_string7guardedFTSS1bSb_Si
+// CHECK-NOT:     _stringSwitchHash
+// CHECK:       } // end sil function '_TF13switch_string7guardedFTSS1bSb_Si'
+func guarded(s: String, b: Bool) -> Int {
+  switch s {
+  case "a": return 0
+  case "b" where b: return 1
+  case "c": return 2
+  case "d": return 3
+  default: return -1
+  }
+}
@@ -0,0 +1,23 @@
+// REQUIRES: asserts
+
+// RUN: %target-swift-frontend -parse %s -print-stats 2>&1 | FileCheck %s
+
+// CHECK: Statistics Collected
+// CHECK-DAG: {{[1-9][0-9]*}} Iterative type checker - # of TypeCheckSuperclass requests processed
+// CHECK-DAG: {{[1-9][0-9]*}} Iterative type checker - # of InheritedProtocols requests processed
+// CHECK-DAG: {{[1-9][0-9]*}} Iterative type checker - # of type check requests satisfied
+// CHECK-DAG: {{[1-9][0-9]*}} Iterative type checker - # of type check requests found already satisfied in the cache
+
+protocol P { }
+protocol Q : P { }
+protocol R : Q { }
+
+class Base : R { }
+class Derived : Base { }
+class MoreDerived : Derived { }
+
+// Each of these needs the superclasses and inherited protocols above, which
+// are only computed once.
+func useBase(b: Base) -> R { return b }
+func useDerived(d: Derived) -> Base { return d }
+func useMoreDerived(m: MoreDerived) -> (Derived, Base, P) { return (m, m, m) }
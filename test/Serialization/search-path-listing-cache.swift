@@ -0,0 +1,41 @@
+// REQUIRES: asserts
+
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/empty1 %t/empty2 %t/modules
+// RUN: %target-swift-frontend -emit-module -o %t/modules %S/Inputs/def_struct.swift
+
+// Listings of directories modified within the last couple of seconds aren't
+// saved, so make the search paths look older.
+// RUN: touch -t 201401240005 %t/empty1 %t/empty2 %t/modules
+
+// The first job lists the search paths, and saves the listings.
+// RUN: %target-swift-frontend -parse %s -I %t/empty1 -I %t/empty2 -I %t/modules -search-path-listing-cache %t/listings -print-stats 2>&1 | FileCheck -check-prefix=FIRST %s
+// RUN: FileCheck -check-prefix=LISTINGS %s < %t/listings
+
+// FIRST: Statistics Collected
+// FIRST-DAG: {{[1-9][0-9]*}} Directory listing cache - # of directories listed
+// FIRST-DAG: {{[1-9][0-9]*}} Directory listing cache - # of file system lookups avoided using directory listings
+
+// LISTINGS: swift-directory-listings-1
+// LISTINGS-DAG: listed {{[0-9]+ [0-9]+}} 0 {{.*}}empty1
+// LISTINGS-DAG: listed {{[0-9]+ [0-9]+}} 0 {{.*}}empty2
+// LISTINGS-DAG: def_struct.swiftmodule
+
+// Later jobs load the listings instead of listing the search paths again.
+// RUN: %target-swift-frontend -parse %s -I %t/empty1 -I %t/empty2 -I %t/modules -search-path-listing-cache %t/listings -print-stats 2>&1 | FileCheck -check-prefix=LATER %s
+
+// LATER: Statistics Collected
+// LATER-DAG: {{[1-9][0-9]*}} Directory listing cache - # of directory listings loaded from a file
+// LATER-DAG: {{[1-9][0-9]*}} Directory listing cache - # of file system lookups avoided using directory listings
+
+// A module added to a search path is found even though its listing was saved
+// before.
+// RUN: %target-swift-frontend -emit-module -o %t/empty1 %S/Inputs/def_enum.swift
+// RUN: %target-swift-frontend -parse %s -I %t/empty1 -I %t/empty2 -I %t/modules -search-path-listing-cache %t/listings -D IMPORT_DEF_ENUM
+
+import def_struct
+#if IMPORT_DEF_ENUM
+import def_enum
+#endif
+
+var a : Empty
@@ -0,0 +1,53 @@
+// RUN: rm -rf %t.mod %t.mcp
+// RUN: mkdir %t.mod
+// RUN: %swift -emit-module -o %t.mod/swift_mod.swiftmodule %S/Inputs/swift_mod.swift -parse-as-library
+
+// The first open generates the interface and writes it to the cache.
+// RUN: env SOURCEKIT_LOGGING=1 %sourcekitd-test -req=interface-gen -module swift_mod -- -I %t.mod -module-cache-path %t.mcp > %t.response 2> %t.log
+// RUN: diff -u %S/gen_swift_module.swift.response %t.response
+// RUN: FileCheck -check-prefix=MISS %s < %t.log
+// RUN: ls %t.mcp/interfaces | FileCheck -check-prefix=CACHE %s
+// CACHE: swift_mod-{{[0-9a-z]+}}.interface
+// MISS-NOT: using cached interface
+// MISS: wrote interface cache: {{.*}}.interface
+
+// Later opens are served from the cache and report the same information.
+// RUN: env SOURCEKIT_LOGGING=1 %sourcekitd-test -req=interface-gen -module swift_mod -- -I %t.mod -module-cache-path %t.mcp > %t.cached.response 2> %t.cached.log
+// RUN: diff -u %S/gen_swift_module.swift.response %t.cached.response
+// RUN: FileCheck -check-prefix=HIT %s < %t.cached.log
+// HIT: using cached interface: {{.*}}swift_mod-{{[0-9a-z]+}}.interface
+
+// Cursor info on a cached interface rebuilds the declarations on demand.
+// RUN: %sourcekitd-test -req=interface-gen-open -module swift_mod -- -I %t.mod -module-cache-path %t.mcp \
+// RUN:      == -req=cursor -pos=2:14 | FileCheck -check-prefix=CURSOR %s
+// CURSOR: source.lang.swift.decl.class
+// CURSOR-NEXT: MyClass
+
+// Interfaces of Clang modules are regenerated when a header changes, even
+// though the .pcm is not rebuilt until the module is imported again.
+// RUN: rm -rf %t.clang %t.clang.mcp
+// RUN: mkdir %t.clang
+// RUN: echo 'module CachedMod { header "CachedMod.h" }' > %t.clang/module.modulemap
+// RUN: echo 'int cachedModFirst(void);' > %t.clang/CachedMod.h
+// RUN: %sourcekitd-test -req=interface-gen -module CachedMod -- -I %t.clang -module-cache-path %t.clang.mcp %clang-importer-sdk > %t.clang.response
+// RUN: env SOURCEKIT_LOGGING=1 %sourcekitd-test -req=interface-gen -module CachedMod -- -I %t.clang -module-cache-path %t.clang.mcp %clang-importer-sdk > %t.clang.cached.response 2> %t.clang.cached.log
+// RUN: diff -u %t.clang.response %t.clang.cached.response
+// RUN: FileCheck -check-prefix=CLANG-HIT %s < %t.clang.cached.log
+// CLANG-HIT: using cached interface: {{.*}}CachedMod-{{[0-9a-z]+}}.interface
+
+// RUN: echo 'int cachedModSecond(void);' >> %t.clang/CachedMod.h
+// RUN: env SOURCEKIT_LOGGING=1 %sourcekitd-test -req=interface-gen -module CachedMod -- -I %t.clang -module-cache-path %t.clang.mcp %clang-importer-sdk > %t.clang.changed.response 2> %t.clang.changed.log
+// RUN: FileCheck -check-prefix=CLANG-CHANGED %s < %t.clang.changed.response
+// RUN: FileCheck -check-prefix=MISS %s < %t.clang.changed.log
+// CLANG-CHANGED: cachedModFirst
+// CLANG-CHANGED: cachedModSecond
+
+// A same-size edit that keeps the modification time is noticed for headers
+// that were modified too recently for their modification time to be trusted.
+// RUN: printf 'int cachedModFirst(void);\n' > %t.clang/CachedMod.h
+// RUN: touch -t 203001010000 %t.clang/CachedMod.h
+// RUN: %sourcekitd-test -req=interface-gen -module CachedMod -- -I %t.clang -module-cache-path %t.clang.mcp %clang-importer-sdk > /dev/null
+// RUN: printf 'int cachedModThird(void);\n' > %t.clang/CachedMod.h
+// RUN: touch -t 203001010000 %t.clang/CachedMod.h
+// RUN: env SOURCEKIT_LOGGING=1 %sourcekitd-test -req=interface-gen -module CachedMod -- -I %t.clang -module-cache-path %t.clang.mcp %clang-importer-sdk > /dev/null 2> %t.clang.same-size.log
+// RUN: FileCheck -check-prefix=MISS %s < %t.clang.same-size.log
@@ -0,0 +1,12 @@
+func foo() -> Int { return 1 }
+let x = foo()
+
+// RUN: sed -e "s|FILE|%s|g" %S/Inputs/replay.log > %t.log
+// RUN: %sourcekitd-test -replay %t.log | FileCheck %s
+// RUN: %sourcekitd-test -replay %t.log -replay-no-delay | FileCheck %s
+
+// CHECK: request {{ *}}count {{ *}}errors
+// CHECK-DAG: source.request.codecomplete {{ *}}1 {{ *}}0
+// CHECK-DAG: source.request.cursorinfo {{ *}}2 {{ *}}0
+// CHECK-DAG: source.request.editor.open {{ *}}1 {{ *}}0
+// CHECK: peak RSS: {{[0-9]+}} KB
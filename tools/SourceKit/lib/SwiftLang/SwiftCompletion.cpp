@@ -16,6 +16,7 @@
 #include "SourceKit/Support/Logging.h"
 #include "SourceKit/Support/UIdent.h"
 
+#include "swift/Basic/Tracing.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/IDE/CodeCompletionCache.h"
@@ -108,6 +109,7 @@ static bool swiftCodeCompleteImpl(SwiftLangSupport &Lang,
                                   SwiftCodeCompletionConsumer &SwiftConsumer,
                                   ArrayRef<const char *> Args,
                                   std::string &Error) {
+  tracing::TracedSpan Span("Code completion", "sourcekit");
 
   trace::TracedOperation TracedOp;
   if (trace::enabled()) {
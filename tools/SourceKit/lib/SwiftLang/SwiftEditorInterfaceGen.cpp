@@ -13,9 +13,13 @@
 #include "SwiftLangSupport.h"
 #include "SwiftInterfaceGenContext.h"
 #include "SwiftASTManager.h"
+#include "SourceKit/Core/NotificationCenter.h"
+#include "SourceKit/Support/Logging.h"
 
 #include "swift/AST/ASTPrinter.h"
 #include "swift/AST/ASTWalker.h"
+#include "swift/Basic/Version.h"
+#include "swift/ClangImporter/ClangModule.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/IDE/ModuleInterfacePrinting.h"
@@ -23,8 +27,15 @@
 #include "swift/IDE/Utils.h"
 #include "swift/Strings.h"
 
+#include "clang/AST/ASTContext.h"
+#include "clang/Basic/Module.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/Path.h"
 
 using namespace SourceKit;
 using namespace swift;
@@ -67,6 +78,16 @@ public:
     llvm::StringMap<TextDecl> USRMap;
   };
 
+  struct ModuleFile {
+    std::string Path;
+    /// The modification time, in nanoseconds since the epoch.
+    uint64_t ModTime;
+    uint64_t Size;
+    /// The MD5 of the contents, if the file had been modified so recently
+    /// that a later change might not change its modification time.
+    std::string ContentHash;
+  };
+
   // Hold an AstUnit so that the Decl* we have are always valid.
   ASTUnitRef AstUnit;
   std::string DocumentName;
@@ -76,15 +97,31 @@ public:
   PrintingDiagnosticConsumer DiagConsumer;
   CompilerInstance Instance;
   Module *Mod = nullptr;
+  bool IsSystemModule = false;
   SourceTextInfo Info;
   // This is the non-typechecked AST for the generated interface source.
   CompilerInstance TextCI;
+
+  // When the interface was loaded from the on-disk cache, this holds the
+  // cached file and the text and recorded editor info within it. Info and
+  // TextCI are then only filled in by ensureASTInfo().
+  std::unique_ptr<llvm::MemoryBuffer> CacheBuffer;
+  StringRef CachedText;
+  StringRef CachedEditorInfo;
+  NotificationCenter *NotificationCtr = nullptr;
+  bool NeedsASTInfo = false;
+  bool ASTInfoFailed = false;
+  llvm::sys::Mutex ASTInfoMtx;
+
+  /// Returns false if Info and TextCI could not be built.
+  bool ensureASTInfo();
 };
 
 typedef SwiftInterfaceGenContext::Implementation::TextRange TextRange;
 typedef SwiftInterfaceGenContext::Implementation::TextReference TextReference;
 typedef SwiftInterfaceGenContext::Implementation::TextDecl TextDecl;
 typedef SwiftInterfaceGenContext::Implementation::SourceTextInfo SourceTextInfo;
+typedef SwiftInterfaceGenContext::Implementation::ModuleFile ModuleFile;
 
 static Module *getModuleByFullName(ASTContext &Ctx, StringRef ModuleName) {
   SmallVector<std::pair<Identifier, SourceLoc>, 4>
@@ -337,26 +374,21 @@ SwiftInterfaceGenContext::createForSwiftSource(StringRef DocumentName,
   return IFaceGenCtx;
 }
 
-SwiftInterfaceGenContextRef
-SwiftInterfaceGenContext::create(StringRef DocumentName,
-                                 bool IsModule,
-                                 StringRef ModuleOrHeaderName,
-                                 CompilerInvocation Invocation,
-                                 std::string &ErrMsg) {
-  SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
-  IFaceGenCtx->Impl.DocumentName = DocumentName;
-  IFaceGenCtx->Impl.IsModule = IsModule;
-  IFaceGenCtx->Impl.ModuleOrHeaderName = ModuleOrHeaderName;
-  IFaceGenCtx->Impl.Invocation = Invocation;
-  CompilerInstance &CI = IFaceGenCtx->Impl.Instance;
+/// Prints the interface for the module or header of \p Impl and parses the
+/// resulting text.
+static bool
+generateInterfaceInfo(SwiftInterfaceGenContext::Implementation &Impl,
+                      std::string &ErrMsg) {
+  CompilerInstance &CI = Impl.Instance;
 
   // Display diagnostics to stderr.
-  CI.addDiagnosticConsumer(&IFaceGenCtx->Impl.DiagConsumer);
+  CI.addDiagnosticConsumer(&Impl.DiagConsumer);
 
+  CompilerInvocation Invocation = Impl.Invocation;
   Invocation.clearInputs();
   if (CI.setup(Invocation)) {
     ErrMsg = "Error during invocation setup";
-    return nullptr;
+    return true;
   }
 
   ASTContext &Ctx = CI.getASTContext();
@@ -366,18 +398,18 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
   auto *Stdlib = getModuleByFullName(Ctx, Ctx.StdlibModuleName);
   if (!Stdlib) {
     ErrMsg = "Could not load the stdlib module";
-    return nullptr;
+    return true;
   }
 
-  if (IsModule) {
-    if (getModuleInterfaceInfo(Ctx, ModuleOrHeaderName, IFaceGenCtx->Impl,
-                               ErrMsg))
-      return nullptr;
+  if (Impl.IsModule) {
+    if (getModuleInterfaceInfo(Ctx, Impl.ModuleOrHeaderName, Impl, ErrMsg))
+      return true;
+    Impl.IsSystemModule = Impl.Mod->isSystemModule();
   } else {
     auto &FEOpts = Invocation.getFrontendOptions();
     if (FEOpts.ImplicitObjCHeaderPath.empty()) {
       ErrMsg = "Implicit ObjC header path is empty";
-      return nullptr;
+      return true;
     }
 
     auto &Importer = static_cast<ClangImporter &>(*Ctx.getClangModuleLoader());
@@ -385,19 +417,604 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
                                   CI.getMainModule(),
                                   /*diagLoc=*/{},
                                   /*trackParsedSymbols=*/true);
-    if (getHeaderInterfaceInfo(Ctx, ModuleOrHeaderName,
-                               IFaceGenCtx->Impl.Info, ErrMsg))
-      return nullptr;
+    if (getHeaderInterfaceInfo(Ctx, Impl.ModuleOrHeaderName, Impl.Info,
+                               ErrMsg))
+      return true;
   }
 
-  if (makeParserAST(IFaceGenCtx->Impl.TextCI, IFaceGenCtx->Impl.Info.Text)) {
+  if (makeParserAST(Impl.TextCI, Impl.Info.Text)) {
     ErrMsg = "Error during syntactic parsing";
+    return true;
+  }
+
+  return false;
+}
+
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenContext::create(StringRef DocumentName,
+                                 bool IsModule,
+                                 StringRef ModuleOrHeaderName,
+                                 CompilerInvocation Invocation,
+                                 std::string &ErrMsg) {
+  SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
+  IFaceGenCtx->Impl.DocumentName = DocumentName;
+  IFaceGenCtx->Impl.IsModule = IsModule;
+  IFaceGenCtx->Impl.ModuleOrHeaderName = ModuleOrHeaderName;
+  IFaceGenCtx->Impl.Invocation = Invocation;
+
+  if (generateInterfaceInfo(IFaceGenCtx->Impl, ErrMsg))
     return nullptr;
+
+  return IFaceGenCtx;
+}
+
+bool SwiftInterfaceGenContext::Implementation::ensureASTInfo() {
+  llvm::sys::ScopedLock L(ASTInfoMtx);
+  if (!NeedsASTInfo)
+    return !ASTInfoFailed;
+  NeedsASTInfo = false;
+
+  std::string ErrMsg;
+  if (generateInterfaceInfo(*this, ErrMsg)) {
+    Info = SourceTextInfo();
+    ASTInfoFailed = true;
+    return false;
+  }
+
+  if (Info.Text == CachedText)
+    return true;
+
+  // The files the interface was printed from were unchanged when the cache
+  // was read, yet printing now gives a different text, so the cache is wrong.
+  // Remove it and switch over to the regenerated interface. The editor's
+  // offsets still refer to the cached text, so fail this query and tell the
+  // editor to fetch the new text.
+  LOG_WARN_FUNC("discarding stale cached interface: "
+                << CacheBuffer->getBufferIdentifier());
+  llvm::sys::fs::remove(CacheBuffer->getBufferIdentifier());
+  CachedText = StringRef();
+  CachedEditorInfo = StringRef();
+  CacheBuffer.reset();
+  if (NotificationCtr)
+    NotificationCtr->postDocumentUpdateNotification(DocumentName);
+  return false;
+}
+
+//============================================================================//
+// On-disk interface cache
+//============================================================================//
+
+/// The version number for the on-disk interface cache.
+///
+/// This should be incremented any time the format of the cache file, or the
+/// options used to print the interface, change.
+static constexpr uint32_t onDiskInterfaceCacheVersion = 2;
+
+namespace {
+enum class CachedEditorInfoKind : uint8_t {
+  SyntaxMap,
+  SemanticAnnotation,
+  BeginSubStructure,
+  EndSubStructure,
+  SubStructureElement,
+};
+
+/// Forwards the editor info for an interface to another consumer, while
+/// recording it so that it can be replayed by \c replayEditorInfo.
+class EditorInfoRecorder : public EditorConsumer {
+  EditorConsumer &Next;
+  llvm::raw_ostream &OS;
+  llvm::support::endian::Writer<llvm::support::little> LE;
+
+  void writeKind(CachedEditorInfoKind Kind) {
+    LE.write(static_cast<uint8_t>(Kind));
+  }
+  void writeString(StringRef Str) {
+    LE.write(static_cast<uint32_t>(Str.size()));
+    OS << Str;
+  }
+  void writeUID(UIdent UID) {
+    writeString(UID.isValid() ? UID.getName() : StringRef());
   }
 
+public:
+  EditorInfoRecorder(EditorConsumer &Next, llvm::raw_ostream &OS)
+    : Next(Next), OS(OS), LE(OS) {}
+
+  bool needsSemanticInfo() override { return Next.needsSemanticInfo(); }
+
+  void handleRequestError(const char *Description) override {
+    Next.handleRequestError(Description);
+  }
+
+  bool handleSyntaxMap(unsigned Offset, unsigned Length,
+                       UIdent Kind) override {
+    writeKind(CachedEditorInfoKind::SyntaxMap);
+    LE.write(static_cast<uint32_t>(Offset));
+    LE.write(static_cast<uint32_t>(Length));
+    writeUID(Kind);
+    return Next.handleSyntaxMap(Offset, Length, Kind);
+  }
+
+  bool handleSemanticAnnotation(unsigned Offset, unsigned Length,
+                                UIdent Kind, bool isSystem) override {
+    writeKind(CachedEditorInfoKind::SemanticAnnotation);
+    LE.write(static_cast<uint32_t>(Offset));
+    LE.write(static_cast<uint32_t>(Length));
+    writeUID(Kind);
+    LE.write(static_cast<uint8_t>(isSystem));
+    return Next.handleSemanticAnnotation(Offset, Length, Kind, isSystem);
+  }
+
+  bool beginDocumentSubStructure(unsigned Offset, unsigned Length,
+                                 UIdent Kind, UIdent AccessLevel,
+                                 UIdent SetterAccessLevel,
+                                 unsigned NameOffset,
+                                 unsigned NameLength,
+                                 unsigned BodyOffset,
+                                 unsigned BodyLength,
+                                 StringRef DisplayName,
+                                 StringRef TypeName,
+                                 StringRef RuntimeName,
+                                 StringRef SelectorName,
+                                 ArrayRef<StringRef> InheritedTypes,
+                                 ArrayRef<UIdent> Attrs) override {
+    writeKind(CachedEditorInfoKind::BeginSubStructure);
+    for (unsigned Val : { Offset, Length, NameOffset, NameLength,
+                          BodyOffset, BodyLength })
+      LE.write(static_cast<uint32_t>(Val));
+    writeUID(Kind);
+    writeUID(AccessLevel);
+    writeUID(SetterAccessLevel);
+    writeString(DisplayName);
+    writeString(TypeName);
+    writeString(RuntimeName);
+    writeString(SelectorName);
+    LE.write(static_cast<uint32_t>(InheritedTypes.size()));
+    for (StringRef Ty : InheritedTypes)
+      writeString(Ty);
+    LE.write(static_cast<uint32_t>(Attrs.size()));
+    for (UIdent Attr : Attrs)
+      writeUID(Attr);
+    return Next.beginDocumentSubStructure(Offset, Length, Kind, AccessLevel,
+                                          SetterAccessLevel, NameOffset,
+                                          NameLength, BodyOffset, BodyLength,
+                                          DisplayName, TypeName, RuntimeName,
+                                          SelectorName, InheritedTypes, Attrs);
+  }
+
+  bool endDocumentSubStructure() override {
+    writeKind(CachedEditorInfoKind::EndSubStructure);
+    return Next.endDocumentSubStructure();
+  }
+
+  bool handleDocumentSubStructureElement(UIdent Kind, unsigned Offset,
+                                         unsigned Length) override {
+    writeKind(CachedEditorInfoKind::SubStructureElement);
+    writeUID(Kind);
+    LE.write(static_cast<uint32_t>(Offset));
+    LE.write(static_cast<uint32_t>(Length));
+    return Next.handleDocumentSubStructureElement(Kind, Offset, Length);
+  }
+
+  bool recordAffectedRange(unsigned Offset, unsigned Length) override {
+    return Next.recordAffectedRange(Offset, Length);
+  }
+
+  bool recordAffectedLineRange(unsigned Line, unsigned Length) override {
+    return Next.recordAffectedLineRange(Line, Length);
+  }
+
+  bool recordFormattedText(StringRef Text) override {
+    return Next.recordFormattedText(Text);
+  }
+
+  bool setDiagnosticStage(UIdent DiagStage) override {
+    return Next.setDiagnosticStage(DiagStage);
+  }
+
+  bool handleDiagnostic(const DiagnosticEntryInfo &Info,
+                        UIdent DiagStage) override {
+    return Next.handleDiagnostic(Info, DiagStage);
+  }
+
+  bool handleSourceText(StringRef Text) override {
+    return Next.handleSourceText(Text);
+  }
+
+  void finished() override { Next.finished(); }
+};
+
+/// Reads the fields written by \c EditorInfoRecorder and the cache file
+/// header, failing on truncated input.
+class CacheReader {
+  const char *Cursor;
+  const char *End;
+
+public:
+  bool Failed = false;
+
+  explicit CacheReader(StringRef Data)
+    : Cursor(Data.begin()), End(Data.end()) {}
+
+  bool atEnd() const { return Failed || Cursor == End; }
+
+  template <typename T>
+  T read() {
+    if (Failed || size_t(End - Cursor) < sizeof(T)) {
+      Failed = true;
+      return T();
+    }
+    T Val = llvm::support::endian::read<T, llvm::support::little,
+                                        llvm::support::unaligned>(Cursor);
+    Cursor += sizeof(T);
+    return Val;
+  }
+
+  StringRef readString() {
+    auto Size = read<uint32_t>();
+    if (Failed || size_t(End - Cursor) < Size) {
+      Failed = true;
+      return StringRef();
+    }
+    StringRef Str(Cursor, Size);
+    Cursor += Size;
+    return Str;
+  }
+
+  UIdent readUID() {
+    StringRef Name = readString();
+    return Name.empty() ? UIdent() : UIdent(Name);
+  }
+};
+} // end anonymous namespace
+
+static void replayEditorInfo(StringRef EditorInfo, EditorConsumer &Consumer) {
+  CacheReader Reader(EditorInfo);
+  while (!Reader.atEnd()) {
+    switch (CachedEditorInfoKind(Reader.read<uint8_t>())) {
+    case CachedEditorInfoKind::SyntaxMap: {
+      unsigned Offset = Reader.read<uint32_t>();
+      unsigned Length = Reader.read<uint32_t>();
+      UIdent Kind = Reader.readUID();
+      if (!Reader.Failed)
+        Consumer.handleSyntaxMap(Offset, Length, Kind);
+      break;
+    }
+    case CachedEditorInfoKind::SemanticAnnotation: {
+      unsigned Offset = Reader.read<uint32_t>();
+      unsigned Length = Reader.read<uint32_t>();
+      UIdent Kind = Reader.readUID();
+      bool IsSystem = Reader.read<uint8_t>();
+      if (!Reader.Failed)
+        Consumer.handleSemanticAnnotation(Offset, Length, Kind, IsSystem);
+      break;
+    }
+    case CachedEditorInfoKind::BeginSubStructure: {
+      unsigned Offset = Reader.read<uint32_t>();
+      unsigned Length = Reader.read<uint32_t>();
+      unsigned NameOffset = Reader.read<uint32_t>();
+      unsigned NameLength = Reader.read<uint32_t>();
+      unsigned BodyOffset = Reader.read<uint32_t>();
+      unsigned BodyLength = Reader.read<uint32_t>();
+      UIdent Kind = Reader.readUID();
+      UIdent AccessLevel = Reader.readUID();
+      UIdent SetterAccessLevel = Reader.readUID();
+      StringRef DisplayName = Reader.readString();
+      StringRef TypeName = Reader.readString();
+      StringRef RuntimeName = Reader.readString();
+      StringRef SelectorName = Reader.readString();
+      SmallVector<StringRef, 4> InheritedTypes;
+      for (unsigned i = 0, e = Reader.read<uint32_t>(); i != e; ++i) {
+        InheritedTypes.push_back(Reader.readString());
+        if (Reader.Failed)
+          break;
+      }
+      SmallVector<UIdent, 4> Attrs;
+      for (unsigned i = 0, e = Reader.read<uint32_t>(); i != e; ++i) {
+        Attrs.push_back(Reader.readUID());
+        if (Reader.Failed)
+          break;
+      }
+      if (!Reader.Failed)
+        Consumer.beginDocumentSubStructure(Offset, Length, Kind, AccessLevel,
+                                           SetterAccessLevel, NameOffset,
+                                           NameLength, BodyOffset, BodyLength,
+                                           DisplayName, TypeName, RuntimeName,
+                                           SelectorName, InheritedTypes, Attrs);
+      break;
+    }
+    case CachedEditorInfoKind::EndSubStructure:
+      Consumer.endDocumentSubStructure();
+      break;
+    case CachedEditorInfoKind::SubStructureElement: {
+      UIdent Kind = Reader.readUID();
+      unsigned Offset = Reader.read<uint32_t>();
+      unsigned Length = Reader.read<uint32_t>();
+      if (!Reader.Failed)
+        Consumer.handleDocumentSubStructureElement(Kind, Offset, Length);
+      break;
+    }
+    }
+  }
+}
+
+std::string
+SwiftInterfaceGenContext::getCacheFilename(StringRef ModuleName,
+                                           const CompilerInvocation &Invok) {
+  // The cached interfaces live next to the modules they are generated from.
+  StringRef ModuleCachePath = Invok.getClangImporterOptions().ModuleCachePath;
+  if (ModuleCachePath.empty() || ModuleName.empty())
+    return std::string();
+
+  // Everything that matches() compares goes into the key, along with the
+  // options affecting what the importer provides. The key is hashed with
+  // MD5, which unlike llvm::hash_combine is stable across executions, and
+  // includes the compiler version, since the printed interface depends on it.
+  const SearchPathOptions &SPOpts = Invok.getSearchPathOptions();
+  const ClangImporterOptions &ClangOpts = Invok.getClangImporterOptions();
+  llvm::MD5 Hash;
+  auto addToHash = [&](StringRef Str) {
+    Hash.update(Str);
+    // Separate the strings, so that "ab","c" and "a","bc" differ.
+    Hash.update(StringRef("\0", 1));
+  };
+  auto addListToHash = [&](ArrayRef<std::string> List) {
+    addToHash(std::to_string(List.size()));
+    for (auto &Str : List)
+      addToHash(Str);
+  };
+  addToHash(std::to_string(onDiskInterfaceCacheVersion));
+  addToHash(version::getSwiftFullVersion());
+  addToHash(ModuleName);
+  addToHash(Invok.getTargetTriple());
+  addToHash(Invok.getSDKPath());
+  addListToHash(SPOpts.ImportSearchPaths);
+  addListToHash(SPOpts.FrameworkSearchPaths);
+  addListToHash(ClangOpts.ExtraArgs);
+  addToHash(ClangOpts.ImportForwardDeclarations ? "1" : "0");
+  llvm::MD5::MD5Result HashResult;
+  Hash.final(HashResult);
+  SmallString<32> HashStr;
+  llvm::MD5::stringifyResult(HashResult, HashStr);
+
+  // ModuleCachePath/interfaces/ModuleName-<hash>.interface
+  SmallString<128> Name(ModuleCachePath);
+  llvm::sys::path::append(Name, "interfaces", ModuleName);
+  Name += "-";
+  Name += HashStr;
+  Name += ".interface";
+  return Name.str();
+}
+
+/// Adds the headers of \p M and its submodules to \p Paths.
+static void collectClangModuleHeaders(const clang::Module *M,
+                                      clang::FileManager &FileMgr,
+                                      SmallVectorImpl<StringRef> &Paths) {
+  if (auto Umbrella = M->getUmbrellaHeader())
+    Paths.push_back(Umbrella.Entry->getName());
+  for (auto &Headers : M->Headers) {
+    for (auto &Header : Headers) {
+      if (Header.Entry)
+        Paths.push_back(Header.Entry->getName());
+    }
+  }
+  // Headers found in an umbrella directory are only listed here.
+  for (auto *File : const_cast<clang::Module *>(M)->getTopHeaders(FileMgr))
+    Paths.push_back(File->getName());
+
+  for (auto I = M->submodule_begin(), E = M->submodule_end(); I != E; ++I)
+    collectClangModuleHeaders(*I, FileMgr, Paths);
+}
+
+/// Returns the MD5 of the contents of \p Path as a hex string, or an empty
+/// string if it can't be read.
+static std::string hashFileContents(StringRef Path) {
+  auto BufferOrErr = llvm::MemoryBuffer::getFile(Path);
+  if (!BufferOrErr)
+    return std::string();
+  llvm::MD5 Hash;
+  Hash.update(BufferOrErr.get()->getBuffer());
+  llvm::MD5::MD5Result HashResult;
+  Hash.final(HashResult);
+  SmallString<32> HashStr;
+  llvm::MD5::stringifyResult(HashResult, HashStr);
+  return HashStr.str();
+}
+
+/// Returns the modification time of \p Status in nanoseconds since the epoch.
+static uint64_t getModTime(const llvm::sys::fs::file_status &Status) {
+  llvm::sys::TimeValue ModTime = Status.getLastModificationTime();
+  return ModTime.toEpochTime() * llvm::sys::TimeValue::NANOSECONDS_PER_SECOND
+      + ModTime.nanoseconds();
+}
+
+/// Collects the files the interface of \p Mod is printed from, along with
+/// their current modification time and size.
+///
+/// These are the module files and, for a Clang module, its headers and the
+/// files of its Swift overlay. A .pcm is only rebuilt when the module is next
+/// imported, so an edited header would not be noticed through it.
+///
+/// Some file systems only record modification times to the second, or two,
+/// so a file that changes again that soon may keep its modification time.
+/// The contents of files modified within that window are hashed as well.
+static void collectModuleFiles(const Module *Mod,
+                               SmallVectorImpl<ModuleFile> &ModuleFiles) {
+  SmallVector<StringRef, 16> Paths;
+  for (auto *File : Mod->getFiles()) {
+    auto *LF = dyn_cast<LoadedFile>(File);
+    if (!LF)
+      continue;
+    Paths.push_back(LF->getFilename());
+
+    auto *CMU = dyn_cast<ClangModuleUnit>(LF);
+    if (!CMU || !CMU->getClangModule())
+      continue;
+    auto &FileMgr = CMU->getClangASTContext().getSourceManager()
+                        .getFileManager();
+    collectClangModuleHeaders(CMU->getClangModule(), FileMgr, Paths);
+    if (auto *Adapter = CMU->getAdapterModule()) {
+      for (auto *AdapterFile : Adapter->getFiles()) {
+        if (auto *AdapterLF = dyn_cast<LoadedFile>(AdapterFile))
+          Paths.push_back(AdapterLF->getFilename());
+      }
+    }
+  }
+
+  auto Now = llvm::sys::TimeValue::now();
+  llvm::StringSet<> Seen;
+  for (StringRef Path : Paths) {
+    if (Path.empty() || !Seen.insert(Path).second)
+      continue;
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(Path, Status))
+      continue;
+    std::string ContentHash;
+    if (Now.seconds() < Status.getLastModificationTime().seconds() + 2)
+      ContentHash = hashFileContents(Path);
+    ModuleFiles.push_back({ Path, getModTime(Status), Status.getSize(),
+                            std::move(ContentHash) });
+  }
+}
+
+/// Returns true if \p Path still has the recorded modification time and size,
+/// and the recorded contents if \p ContentHash is not empty.
+static bool isModuleFileUpToDate(StringRef Path, uint64_t ModTime,
+                                 uint64_t Size, StringRef ContentHash) {
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(Path, Status))
+    return false;
+  if (getModTime(Status) != ModTime || Status.getSize() != Size)
+    return false;
+  return ContentHash.empty() || hashFileContents(Path) == ContentHash;
+}
+
+/// The cache file consists of:
+///
+///   HEADER
+///     * The format version.
+///     * Whether the module is a system module.
+///     * The files the interface was printed from, as collected by
+///       \c collectModuleFiles, each with its modification time, size, and
+///       content hash if any. The cache is stale if any changed.
+///
+///   TEXT
+///     * The length-prefixed interface source text.
+///
+///   EDITOR INFO
+///     * The rest of the file, as recorded by \c EditorInfoRecorder.
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenContext::createFromCache(StringRef DocumentName,
+                                          StringRef ModuleName,
+                                          CompilerInvocation Invocation,
+                                          StringRef CacheFilename,
+                                          NotificationCenter &NotificationCtr) {
+  auto BufferOrErr = llvm::MemoryBuffer::getFile(CacheFilename);
+  if (!BufferOrErr)
+    return nullptr;
+  std::unique_ptr<llvm::MemoryBuffer> Buffer = std::move(BufferOrErr.get());
+
+  CacheReader Reader(Buffer->getBuffer());
+  if (Reader.read<uint32_t>() != onDiskInterfaceCacheVersion)
+    return nullptr;
+  bool IsSystemModule = Reader.read<uint8_t>();
+  unsigned NumModuleFiles = Reader.read<uint32_t>();
+  if (Reader.Failed || NumModuleFiles == 0)
+    return nullptr;
+  for (unsigned i = 0; i != NumModuleFiles; ++i) {
+    StringRef Path = Reader.readString();
+    auto ModTime = Reader.read<uint64_t>();
+    auto Size = Reader.read<uint64_t>();
+    StringRef ContentHash = Reader.readString();
+    if (Reader.Failed ||
+        !isModuleFileUpToDate(Path, ModTime, Size, ContentHash))
+      return nullptr;
+  }
+  StringRef Text = Reader.readString();
+  if (Reader.Failed)
+    return nullptr;
+
+  SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
+  Implementation &Impl = IFaceGenCtx->Impl;
+  Impl.DocumentName = DocumentName;
+  Impl.IsModule = true;
+  Impl.ModuleOrHeaderName = ModuleName;
+  Impl.Invocation = Invocation;
+  Impl.IsSystemModule = IsSystemModule;
+  Impl.CachedText = Text;
+  Impl.CachedEditorInfo = StringRef(Text.end(),
+                                    Buffer->getBufferEnd() - Text.end());
+  Impl.CacheBuffer = std::move(Buffer);
+  Impl.NotificationCtr = &NotificationCtr;
+  Impl.NeedsASTInfo = true;
+  LOG_INFO_FUNC(High, "using cached interface: " << CacheFilename);
   return IFaceGenCtx;
 }
 
+void SwiftInterfaceGenContext::reportAndCacheEditorInfo(
+    EditorConsumer &Consumer, StringRef CacheFilename) const {
+  // Only interfaces of modules loaded from files can be validated later.
+  SmallVector<ModuleFile, 8> ModuleFiles;
+  if (Impl.IsModule && Impl.Mod)
+    collectModuleFiles(Impl.Mod, ModuleFiles);
+  if (ModuleFiles.empty())
+    return reportEditorInfo(Consumer);
+
+  std::string Contents;
+  llvm::raw_string_ostream OS(Contents);
+  llvm::support::endian::Writer<llvm::support::little> LE(OS);
+  auto writeString = [&](StringRef Str) {
+    LE.write(static_cast<uint32_t>(Str.size()));
+    OS << Str;
+  };
+
+  // HEADER
+  LE.write(onDiskInterfaceCacheVersion);
+  LE.write(static_cast<uint8_t>(Impl.IsSystemModule));
+  LE.write(static_cast<uint32_t>(ModuleFiles.size()));
+  for (auto &File : ModuleFiles) {
+    writeString(File.Path);
+    LE.write(File.ModTime);
+    LE.write(File.Size);
+    writeString(File.ContentHash);
+  }
+
+  // TEXT
+  writeString(Impl.Info.Text);
+
+  // EDITOR INFO
+  EditorInfoRecorder Recorder(Consumer, OS);
+  reportEditorInfo(Recorder);
+  OS.flush();
+
+  // Failing to write the cache only costs a regeneration on the next open.
+  if (llvm::sys::fs::create_directories(
+          llvm::sys::path::parent_path(CacheFilename)))
+    return;
+  SmallString<128> TmpName(CacheFilename);
+  TmpName += "-%%%%%%";
+  int TmpFD;
+  if (llvm::sys::fs::createUniqueFile(TmpName.str(), TmpFD, TmpName))
+    return;
+  {
+    llvm::raw_fd_ostream Out(TmpFD, /*shouldClose=*/true);
+    Out << Contents;
+    Out.flush();
+    if (Out.has_error()) {
+      Out.clear_error();
+      llvm::sys::fs::remove(TmpName.str());
+      return;
+    }
+  }
+  // Atomically rename the file into its final location.
+  if (llvm::sys::fs::rename(TmpName.str(), CacheFilename)) {
+    llvm::sys::fs::remove(TmpName.str());
+    return;
+  }
+  LOG_INFO_FUNC(High, "wrote interface cache: " << CacheFilename);
+}
+
 SwiftInterfaceGenContext::SwiftInterfaceGenContext()
   : Impl(*new Implementation) {
 }
@@ -433,7 +1050,7 @@ bool SwiftInterfaceGenContext::matches(StringRef ModuleName,
   if (Invok.getSDKPath() != Impl.Invocation.getSDKPath())
     return false;
 
-  if (Impl.Mod->isSystemModule())
+  if (Impl.IsSystemModule)
     return true;
 
   const SearchPathOptions &SPOpts = Invok.getSearchPathOptions();
@@ -451,6 +1068,17 @@ bool SwiftInterfaceGenContext::matches(StringRef ModuleName,
 }
 
 void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const {
+  {
+    // ensureASTInfo() may drop a stale cache from another thread.
+    llvm::sys::ScopedLock L(Impl.ASTInfoMtx);
+    if (Impl.CacheBuffer) {
+      Consumer.handleSourceText(Impl.CachedText);
+      replayEditorInfo(Impl.CachedEditorInfo, Consumer);
+      Consumer.finished();
+      return;
+    }
+  }
+
   Consumer.handleSourceText(Impl.Info.Text);
   reportSyntacticAnnotations(Impl.TextCI, Consumer);
   reportDocumentStructure(Impl.TextCI, Consumer);
@@ -460,6 +1088,9 @@ void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const
 
 SwiftInterfaceGenContext::ResolvedEntity
 SwiftInterfaceGenContext::resolveEntityForOffset(unsigned Offset) const {
+  if (!Impl.ensureASTInfo())
+    return ResolvedEntity();
+
   // Search among the references.
   {
     auto Pos = std::upper_bound(Impl.Info.References.begin(),
@@ -499,6 +1130,8 @@ SwiftInterfaceGenContext::resolveEntityForOffset(unsigned Offset) const {
 
 llvm::Optional<std::pair<unsigned, unsigned>>
 SwiftInterfaceGenContext::findUSRRange(StringRef USR) const {
+  if (!Impl.ensureASTInfo())
+    return None;
   auto Pos = Impl.Info.USRMap.find(USR);
   if (Pos == Impl.Info.USRMap.end())
     return None;
@@ -576,6 +1209,19 @@ void SwiftLangSupport::editorOpenInterface(EditorConsumer &Consumer,
 
   Invocation.getClangImporterOptions().ImportForwardDeclarations = true;
 
+  // Serve the interface from the on-disk cache if it is up to date.
+  std::string CacheFilename =
+      SwiftInterfaceGenContext::getCacheFilename(ModuleName, Invocation);
+  if (!CacheFilename.empty()) {
+    if (auto IFaceGenRef = SwiftInterfaceGenContext::createFromCache(
+            Name, ModuleName, Invocation, CacheFilename,
+            getContext().getNotificationCenter())) {
+      IFaceGenContexts.set(Name, IFaceGenRef);
+      IFaceGenRef->reportEditorInfo(Consumer);
+      return;
+    }
+  }
+
   std::string ErrMsg;
   auto IFaceGenRef = SwiftInterfaceGenContext::create(Name,
                                                       /*IsModule=*/true,
@@ -588,7 +1234,10 @@ void SwiftLangSupport::editorOpenInterface(EditorConsumer &Consumer,
   }
 
   IFaceGenContexts.set(Name, IFaceGenRef);
-  IFaceGenRef->reportEditorInfo(Consumer);
+  if (CacheFilename.empty())
+    IFaceGenRef->reportEditorInfo(Consumer);
+  else
+    IFaceGenRef->reportAndCacheEditorInfo(Consumer, CacheFilename);
 }
 
 class PrimaryFileInterfaceConsumer : public SwiftASTConsumer {
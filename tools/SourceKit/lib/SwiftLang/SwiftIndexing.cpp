@@ -17,6 +17,7 @@
 #include "SourceKit/Support/UIdent.h"
 
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/IDE/SourceEntityWalker.h"
@@ -961,6 +962,7 @@ static void indexModule(llvm::MemoryBuffer *Input,
                         IndexingConsumer &IdxConsumer,
                         CompilerInstance &CI,
                         ArrayRef<const char *> Args) {
+  tracing::TracedSpan Span("Indexing module", "sourcekit");
   trace::TracedOperation TracedOp;
   if (trace::enabled()) {
     trace::SwiftInvocation SwiftArgs;
@@ -1036,6 +1038,7 @@ void SwiftLangSupport::indexSource(StringRef InputFile,
                                    IndexingConsumer &IdxConsumer,
                                    ArrayRef<const char *> Args,
                                    StringRef Hash) {
+  tracing::TracedSpan Span("Indexing source", "sourcekit");
   std::string Error;
   auto InputBuf = ASTMgr->getMemoryBuffer(InputFile, Error);
   if (!InputBuf) {
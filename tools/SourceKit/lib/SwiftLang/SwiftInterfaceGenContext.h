@@ -25,6 +25,7 @@ namespace swift {
 
 namespace SourceKit {
   class EditorConsumer;
+  class NotificationCenter;
   class SwiftInterfaceGenContext;
   typedef RefPtr<SwiftInterfaceGenContext> SwiftInterfaceGenContextRef;
   class ASTUnit;
@@ -39,6 +40,25 @@ public:
                                             swift::CompilerInvocation Invocation,
                                             std::string &ErrorMsg);
 
+  /// Creates a context for the module interface stored in \p CacheFilename by
+  /// a previous \c reportAndCacheEditorInfo call.
+  ///
+  /// Returns null if there is no cached interface or it is out of date with
+  /// the files it was generated from. The AST-backed information, needed for
+  /// cursor and USR queries, is only rebuilt when first used; if the rebuilt
+  /// interface turns out to differ from the cached one, the cache is removed
+  /// and a document update notification is posted through \p NotificationCtr.
+  static SwiftInterfaceGenContextRef
+  createFromCache(StringRef DocumentName, StringRef ModuleName,
+                  swift::CompilerInvocation Invocation,
+                  StringRef CacheFilename,
+                  NotificationCenter &NotificationCtr);
+
+  /// Returns the file that caches the generated interface of \p ModuleName
+  /// for \p Invok, or an empty string if on-disk caching is not possible.
+  static std::string getCacheFilename(StringRef ModuleName,
+                                      const swift::CompilerInvocation &Invok);
+
   static SwiftInterfaceGenContextRef createForSwiftSource(StringRef DocumentName,
                                                           StringRef SourceFileName,
                                                           ASTUnitRef AstUnit,
@@ -54,6 +74,11 @@ public:
 
   void reportEditorInfo(EditorConsumer &Consumer) const;
 
+  /// Like \c reportEditorInfo, but also writes the generated interface and
+  /// the reported information to \p CacheFilename.
+  void reportAndCacheEditorInfo(EditorConsumer &Consumer,
+                                StringRef CacheFilename) const;
+
   struct ResolvedEntity {
     const swift::ValueDecl *Dcl = nullptr;
     swift::ModuleEntity Mod;
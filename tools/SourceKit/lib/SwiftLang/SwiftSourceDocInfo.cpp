@@ -20,6 +20,7 @@
 #include "swift/AST/Decl.h"
 #include "swift/AST/NameLookup.h"
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/IDE/SourceEntityWalker.h"
@@ -481,6 +482,7 @@ static void resolveCursor(SwiftLangSupport &Lang,
     }
 
     void handlePrimaryAST(ASTUnitRef AstUnit) override {
+      tracing::TracedSpan Span("Cursor info", "sourcekit");
       auto &CompIns = AstUnit->getCompilerInstance();
       Module *MainModule = CompIns.getMainModule();
 
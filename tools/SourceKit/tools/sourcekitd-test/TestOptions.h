@@ -52,6 +52,8 @@ struct TestOptions {
   std::string SourceFile;
   std::string TextInputFile;
   std::string JsonRequestPath;
+  std::string ReplayPath;
+  bool ReplayNoDelay = false;
   llvm::Optional<std::string> SourceText;
   unsigned Line = 0;
   unsigned Col = 0;
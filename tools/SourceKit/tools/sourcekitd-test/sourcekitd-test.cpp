@@ -16,15 +16,21 @@
 #include "clang/Rewrite/Core/RewriteBuffer.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/FileSystem.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <thread>
 #include <unistd.h>
 #include <sys/param.h>
+#include <sys/resource.h>
 
 // FIXME: Platform compatibility.
 #include <dispatch/dispatch.h>
@@ -307,6 +313,152 @@ static int handleJsonRequestPath(StringRef QueryPath) {
   return Error ? 1 : 0;
 }
 
+namespace {
+/// A request read from a replay log.
+struct ReplayEntry {
+  /// When the request was originally sent, in milliseconds since the first
+  /// request of the log.
+  unsigned TimeMS = 0;
+  /// The line of the log on which the request starts.
+  unsigned Line = 0;
+  /// The request, in JSON format.
+  std::string Text;
+};
+} // end anonymous namespace
+
+/// Reads a replay log.
+///
+/// A log is a sequence of requests in the format accepted by
+/// -json-request-path. Each request is preceded by a line starting with
+/// '---', optionally followed by the time in milliseconds at which the
+/// request was sent. Lines starting with '#' are ignored.
+static bool parseReplayLog(StringRef Log, std::vector<ReplayEntry> &Entries) {
+  SmallVector<StringRef, 128> Lines;
+  Log.split(Lines, "\n");
+
+  for (unsigned i = 0, e = Lines.size(); i != e; ++i) {
+    StringRef Line = Lines[i];
+    if (Line.startswith("---")) {
+      Entries.emplace_back();
+      Entries.back().Line = i + 1;
+      StringRef Time = Line.substr(3).trim();
+      if (!Time.empty() && Time.getAsInteger(10, Entries.back().TimeMS)) {
+        llvm::errs() << "error: replay log line " << i + 1
+                     << ": expected time in milliseconds after '---'\n";
+        return true;
+      }
+      continue;
+    }
+    if (Line.ltrim().startswith("#"))
+      continue;
+    if (Entries.empty()) {
+      if (Line.trim().empty())
+        continue;
+      llvm::errs() << "error: replay log line " << i + 1
+                   << ": expected '---' before the first request\n";
+      return true;
+    }
+    Entries.back().Text += Line;
+    Entries.back().Text += '\n';
+  }
+  return false;
+}
+
+/// Returns the value of 'key.request' in the JSON format request \p Text.
+static StringRef getReplayRequestKind(StringRef Text) {
+  StringRef Key = "key.request:";
+  size_t Pos = Text.find(Key);
+  if (Pos == StringRef::npos)
+    return "<unknown>";
+  StringRef Value = Text.substr(Pos + Key.size()).ltrim();
+  return Value.substr(0, Value.find_first_of(",}\n")).rtrim();
+}
+
+/// Returns the \p Percent percentile of the sorted values \p Sorted.
+static double getPercentile(ArrayRef<double> Sorted, unsigned Percent) {
+  assert(!Sorted.empty());
+  size_t Rank = (Sorted.size() * Percent + 99) / 100;
+  return Sorted[std::max<size_t>(Rank, 1) - 1];
+}
+
+/// Returns the peak resident set size of this process, in kilobytes.
+static uint64_t getPeakRSSInKB() {
+  struct rusage Usage;
+  if (getrusage(RUSAGE_SELF, &Usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return Usage.ru_maxrss / 1024;
+#else
+  return Usage.ru_maxrss;
+#endif
+}
+
+static int handleReplay(StringRef LogPath, bool NoDelay) {
+  std::vector<ReplayEntry> Entries;
+  if (parseReplayLog(getBufferForFilename(LogPath)->getBuffer(), Entries))
+    return 1;
+
+  struct KindStats {
+    std::vector<double> LatenciesMS;
+    unsigned Errors = 0;
+  };
+  llvm::StringMap<KindStats> Stats;
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point Start = Clock::now();
+  for (const ReplayEntry &Entry : Entries) {
+    char *Err = nullptr;
+    auto Req = sourcekitd_request_create_from_yaml(Entry.Text.c_str(), &Err);
+    if (!Req) {
+      assert(Err);
+      llvm::errs() << "error: replay log line " << Entry.Line << ": " << Err;
+      free(Err);
+      return 1;
+    }
+
+    // Keep the original spacing between requests, unless a request took
+    // longer than that, in which case the next one is sent right away.
+    if (!NoDelay)
+      std::this_thread::sleep_until(Start +
+                                    std::chrono::milliseconds(Entry.TimeMS));
+
+    Clock::time_point Begin = Clock::now();
+    sourcekitd_response_t Resp = sourcekitd_send_request_sync(Req);
+    Clock::time_point End = Clock::now();
+
+    KindStats &KS = Stats[getReplayRequestKind(Entry.Text)];
+    KS.LatenciesMS.push_back(
+        std::chrono::duration<double, std::milli>(End - Begin).count());
+    if (sourcekitd_response_is_error(Resp))
+      ++KS.Errors;
+
+    sourcekitd_response_dispose(Resp);
+    sourcekitd_request_release(Req);
+  }
+
+  std::vector<StringRef> Kinds;
+  for (auto &Entry : Stats)
+    Kinds.push_back(Entry.getKey());
+  std::sort(Kinds.begin(), Kinds.end());
+
+  llvm::outs() << llvm::format("%-50s %6s %6s %9s %9s %9s %9s\n", "request",
+                               "count", "errors", "p50(ms)", "p90(ms)",
+                               "p99(ms)", "max(ms)");
+  for (StringRef Kind : Kinds) {
+    KindStats &KS = Stats[Kind];
+    std::sort(KS.LatenciesMS.begin(), KS.LatenciesMS.end());
+    llvm::outs() << llvm::format("%-50s %6u %6u %9.2f %9.2f %9.2f %9.2f\n",
+                                 Kind.str().c_str(),
+                                 unsigned(KS.LatenciesMS.size()), KS.Errors,
+                                 getPercentile(KS.LatenciesMS, 50),
+                                 getPercentile(KS.LatenciesMS, 90),
+                                 getPercentile(KS.LatenciesMS, 99),
+                                 KS.LatenciesMS.back());
+  }
+  llvm::outs() << "peak RSS: " << getPeakRSSInKB() << " KB\n";
+  return 0;
+}
+
 static int handleTestInvocation(ArrayRef<const char *> Args,
                                 TestOptions &InitOpts) {
 
@@ -324,6 +476,9 @@ static int handleTestInvocation(ArrayRef<const char *> Args,
   if (!Opts.JsonRequestPath.empty())
     return handleJsonRequestPath(Opts.JsonRequestPath);
 
+  if (!Opts.ReplayPath.empty())
+    return handleReplay(Opts.ReplayPath, Opts.ReplayNoDelay);
+
   if (Optargc < Args.size())
     Opts.CompilerArgs = Args.slice(Optargc+1);
 
@@ -22,6 +22,8 @@
 #include "SourceKit/Support/Logging.h"
 #include "SourceKit/Support/UIdent.h"
 
+#include "swift/Basic/Tracing.h"
+
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
@@ -113,7 +115,15 @@ static void onDocumentUpdateNotification(StringRef DocumentName) {
 
 static SourceKit::Context *GlobalCtx = nullptr;
 
+/// If set, the file to write the timeline of requests to on shutdown, in the
+/// Chrome trace event format.
+static const char *TraceEventsPath = nullptr;
+
 void sourcekitd::initialize() {
+  TraceEventsPath = ::getenv("SOURCEKIT_TRACE_EVENTS_PATH");
+  if (TraceEventsPath)
+    swift::tracing::enable();
+
   GlobalCtx = new SourceKit::Context(sourcekitd::getRuntimeLibPath());
   GlobalCtx->getNotificationCenter().addDocumentUpdateNotificationReceiver(
     onDocumentUpdateNotification);
@@ -121,6 +131,12 @@ void sourcekitd::initialize() {
 void sourcekitd::shutdown() {
   delete GlobalCtx;
   GlobalCtx = nullptr;
+
+  if (TraceEventsPath) {
+    if (std::error_code EC = swift::tracing::writeChromeTrace(TraceEventsPath))
+      LOG_WARN_FUNC("failed to write trace events to " << TraceEventsPath
+                    << ": " << EC.message());
+  }
 }
 
 static SourceKit::Context &getGlobalContext() {
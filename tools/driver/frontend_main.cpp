@@ -25,9 +25,11 @@
 #include "swift/AST/NameLookup.h"
 #include "swift/AST/ReferencedNameTracker.h"
 #include "swift/AST/TypeRefinementContext.h"
+#include "swift/Basic/DirectoryListingCache.h"
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/FileSystem.h"
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Tracing.h"
 #include "swift/Frontend/DiagnosticVerifier.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
@@ -1090,6 +1092,11 @@ int frontend_main(ArrayRef<const char *>Args,
     llvm::EnableStatistics();
   }
 
+  const std::string &traceEventsPath =
+    Invocation.getFrontendOptions().TraceEventsPath;
+  if (!traceEventsPath.empty())
+    tracing::enable();
+
   if (Invocation.getDiagnosticOptions().VerifyDiagnostics) {
     enableDiagnosticVerifier(Instance.getSourceMgr());
   }
@@ -1108,6 +1115,21 @@ int frontend_main(ArrayRef<const char *>Args,
   bool HadError = performCompile(Instance, Invocation, Args, ReturnValue) ||
                   Instance.getASTContext().hadError();
 
+  // Share any search paths this job listed with later jobs. The listings
+  // are only an optimization, so failing to save them isn't an error.
+  const std::string &listingCachePath =
+    Invocation.getSearchPathOptions().SearchPathListingCachePath;
+  if (!listingCachePath.empty())
+    (void)DirectoryListingCache::get().save(listingCachePath);
+
+  if (!traceEventsPath.empty()) {
+    if (std::error_code EC = tracing::writeChromeTrace(traceEventsPath)) {
+      Instance.getDiags().diagnose(SourceLoc(), diag::error_opening_output,
+                                   traceEventsPath, EC.message());
+      HadError = true;
+    }
+  }
+
   if (!HadError && !Invocation.getFrontendOptions().DumpAPIPath.empty()) {
     HadError = dumpAPI(Instance.getMainModule(),
                        Invocation.getFrontendOptions().DumpAPIPath);
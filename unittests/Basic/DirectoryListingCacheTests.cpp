@@ -0,0 +1,151 @@
+//===- DirectoryListingCacheTests.cpp - for swift/Basic/DirectoryListingCache.h
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/DirectoryListingCache.h"
+#include "swift/Basic/LLVM.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+#define ASSERT_NO_ERROR(x)                                                     \
+  do if (std::error_code ASSERT_NO_ERROR_ec = x) {                             \
+    llvm::errs() << #x ": did not return errc::success.\n"                     \
+      << "error number: " << ASSERT_NO_ERROR_ec.value() << "\n"                \
+      << "error message: " << ASSERT_NO_ERROR_ec.message() << "\n";            \
+    FAIL();                                                                    \
+  } while (0)
+
+using namespace llvm::sys;
+using namespace swift;
+
+namespace {
+static std::string inDir(StringRef dir, StringRef rest) {
+  llvm::SmallString<128> result = dir;
+  path::append(result, rest);
+  return result.str();
+}
+
+static void createEmptyFile(StringRef path) {
+  std::error_code error;
+  llvm::raw_fd_ostream emptyOut(path, error, fs::F_None);
+  ASSERT_NO_ERROR(error);
+}
+
+static void makeOld(StringRef path) {
+  int fd;
+  ASSERT_NO_ERROR(fs::openFileForRead(path, fd));
+  llvm::sys::TimeValue old(1390521900, 0);
+  std::error_code error = fs::setLastModificationAndAccessTime(fd, old);
+  Process::SafelyCloseFileDescriptor(fd);
+  ASSERT_NO_ERROR(error);
+}
+
+TEST(DirectoryListingCache, MayContain) {
+  llvm::SmallString<128> dirPath;
+  ASSERT_NO_ERROR(fs::createUniqueDirectory("DirectoryListingCache-test",
+                                            dirPath));
+  createEmptyFile(inDir(dirPath, "Present.swiftmodule"));
+
+  DirectoryListingCache cache;
+  EXPECT_TRUE(cache.mayContain(dirPath, "Present.swiftmodule"));
+  EXPECT_TRUE(cache.mayContain(dirPath, "present.SWIFTMODULE"));
+  EXPECT_FALSE(cache.mayContain(dirPath, "Absent.swiftmodule"));
+
+  // Names that aren't ASCII are never ruled out.
+  EXPECT_TRUE(cache.mayContain(dirPath, "Ab\xC3\xA9sent.swiftmodule"));
+
+  // A directory that doesn't exist contains nothing.
+  EXPECT_FALSE(cache.mayContain(inDir(dirPath, "missing"),
+                                 "Present.swiftmodule"));
+
+  // Clean up.
+  ASSERT_NO_ERROR(fs::remove(inDir(dirPath, "Present.swiftmodule"), false));
+  ASSERT_NO_ERROR(fs::remove(dirPath, false));
+}
+
+TEST(DirectoryListingCache, MayExist) {
+  llvm::SmallString<128> dirPath;
+  ASSERT_NO_ERROR(fs::createUniqueDirectory("DirectoryListingCache-test",
+                                            dirPath));
+  llvm::SmallString<128> frameworkPath = dirPath;
+  path::append(frameworkPath, "Foo.framework");
+  ASSERT_NO_ERROR(fs::create_directory(frameworkPath));
+
+  DirectoryListingCache cache;
+
+  // Nothing has been listed yet.
+  EXPECT_TRUE(cache.mayExist(inDir(dirPath, "Bar.framework/Headers/Bar.h")));
+
+  cache.listDirectory(dirPath);
+  EXPECT_TRUE(cache.mayExist(inDir(dirPath, "Foo.framework/Headers/Foo.h")));
+  EXPECT_FALSE(cache.mayExist(inDir(dirPath, "Bar.framework/Headers/Bar.h")));
+  EXPECT_FALSE(cache.mayExist(inDir(dirPath, "Bar.h")));
+  EXPECT_TRUE(cache.mayExist(inDir(dirPath, "../Bar.h")));
+
+  // Clean up.
+  ASSERT_NO_ERROR(fs::remove(frameworkPath, false));
+  ASSERT_NO_ERROR(fs::remove(dirPath, false));
+}
+
+TEST(DirectoryListingCache, SaveAndLoad) {
+  llvm::SmallString<128> dirPath;
+  ASSERT_NO_ERROR(fs::createUniqueDirectory("DirectoryListingCache-test",
+                                            dirPath));
+  llvm::SmallString<128> searchPath = dirPath;
+  path::append(searchPath, "search");
+  ASSERT_NO_ERROR(fs::create_directory(searchPath));
+  createEmptyFile(inDir(searchPath, "Present.swiftmodule"));
+  llvm::SmallString<128> listingsPath = dirPath;
+  path::append(listingsPath, "listings");
+
+  // A directory that was just modified isn't saved, because another change
+  // might not change its modification time.
+  {
+    DirectoryListingCache cache;
+    EXPECT_FALSE(cache.mayContain(searchPath, "Absent.swiftmodule"));
+    ASSERT_NO_ERROR(cache.save(listingsPath));
+  }
+  {
+    DirectoryListingCache cache;
+    ASSERT_NO_ERROR(cache.load(listingsPath));
+    EXPECT_TRUE(cache.mayExist(inDir(searchPath, "Absent.swiftmodule")));
+  }
+
+  makeOld(searchPath);
+  {
+    DirectoryListingCache cache;
+    EXPECT_FALSE(cache.mayContain(searchPath, "Absent.swiftmodule"));
+    ASSERT_NO_ERROR(cache.save(listingsPath));
+  }
+
+  {
+    DirectoryListingCache cache;
+    ASSERT_NO_ERROR(cache.load(listingsPath));
+    EXPECT_FALSE(cache.mayExist(inDir(searchPath, "Absent.swiftmodule")));
+    EXPECT_TRUE(cache.mayExist(inDir(searchPath, "Present.swiftmodule")));
+  }
+
+  // Loading a file that isn't a listings file fails.
+  {
+    DirectoryListingCache cache;
+    ASSERT_TRUE((bool)cache.load(inDir(searchPath, "Present.swiftmodule")));
+  }
+
+  // Clean up.
+  ASSERT_NO_ERROR(fs::remove(listingsPath, false));
+  ASSERT_NO_ERROR(fs::remove(inDir(searchPath, "Present.swiftmodule"), false));
+  ASSERT_NO_ERROR(fs::remove(searchPath, false));
+  ASSERT_NO_ERROR(fs::remove(dirPath, false));
+}
+} // anonymous namespace
@@ -0,0 +1,105 @@
+//===- TaskQueueTest.cpp - for swift/Basic/TaskQueue.h --------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/TaskQueue.h"
+#include "swift/Basic/LLVM.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace swift;
+using namespace swift::sys;
+
+#if LLVM_ON_UNIX
+
+namespace {
+const char *const ShellPath = "/bin/sh";
+
+TEST(TaskQueue, ManyTasks) {
+  const char *Args[] = { "-c", "echo hello" };
+  const unsigned NumTasks = 1000;
+
+  TaskQueue TQ(16);
+  for (unsigned i = 0; i != NumTasks; ++i)
+    TQ.addTask(ShellPath, Args, llvm::None,
+               reinterpret_cast<void *>(static_cast<uintptr_t>(i)));
+
+  std::vector<bool> SeenTasks(NumTasks);
+  unsigned NumBegan = 0;
+  unsigned NumFinished = 0;
+  bool Failed = TQ.execute(
+      [&](ProcessId Pid, void *Context) { ++NumBegan; },
+      [&](ProcessId Pid, int ReturnCode, StringRef Output,
+          void *Context) -> TaskFinishedResponse {
+        ++NumFinished;
+        SeenTasks[reinterpret_cast<uintptr_t>(Context)] = true;
+        EXPECT_EQ(0, ReturnCode);
+        EXPECT_EQ("hello\n", Output);
+        return TaskFinishedResponse::ContinueExecution;
+      });
+
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(NumTasks, NumBegan);
+  EXPECT_EQ(NumTasks, NumFinished);
+  for (unsigned i = 0; i != NumTasks; ++i)
+    EXPECT_TRUE(SeenTasks[i]);
+}
+
+TEST(TaskQueue, OutputLargerThanPipeBuffer) {
+  // Several tasks each write far more than a pipe can hold, so they can only
+  // finish if their output is drained while the others run.
+  const char *Args[] = { "-c", "head -c 1048576 /dev/zero" };
+  const unsigned NumTasks = 8;
+
+  TaskQueue TQ(NumTasks);
+  for (unsigned i = 0; i != NumTasks; ++i)
+    TQ.addTask(ShellPath, Args);
+
+  unsigned NumFinished = 0;
+  bool Failed = TQ.execute(
+      nullptr,
+      [&](ProcessId Pid, int ReturnCode, StringRef Output,
+          void *Context) -> TaskFinishedResponse {
+        ++NumFinished;
+        EXPECT_EQ(0, ReturnCode);
+        EXPECT_EQ(1048576u, Output.size());
+        return TaskFinishedResponse::ContinueExecution;
+      });
+
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(NumTasks, NumFinished);
+}
+
+TEST(TaskQueue, StopAfterFailure) {
+  const char *Args[] = { "-c", "exit 1" };
+
+  TaskQueue TQ(1);
+  for (unsigned i = 0; i != 10; ++i)
+    TQ.addTask(ShellPath, Args);
+
+  unsigned NumFinished = 0;
+  bool Failed = TQ.execute(
+      nullptr,
+      [&](ProcessId Pid, int ReturnCode, StringRef Output,
+          void *Context) -> TaskFinishedResponse {
+        ++NumFinished;
+        EXPECT_EQ(1, ReturnCode);
+        return TaskFinishedResponse::StopExecution;
+      });
+
+  EXPECT_TRUE(Failed);
+  EXPECT_EQ(1u, NumFinished);
+}
+} // end anonymous namespace
+
+#endif
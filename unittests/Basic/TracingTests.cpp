@@ -0,0 +1,114 @@
+//===- TracingTests.cpp - for swift/Basic/Tracing.h -----------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/Tracing.h"
+#include "swift/Basic/LLVM.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace swift;
+using namespace swift::tracing;
+
+namespace {
+/// Returns the value of \p field in each recorded span named \p name.
+static std::vector<std::string> getSpanFields(StringRef name,
+                                              StringRef field) {
+  std::string trace;
+  llvm::raw_string_ostream os(trace);
+  writeChromeTrace(os);
+  os.flush();
+
+  std::string key = "\"name\":\"" + name.str() + "\"";
+  std::string fieldKey = "\"" + field.str() + "\":";
+  std::vector<std::string> values;
+  for (size_t pos = trace.find(key); pos != std::string::npos;
+       pos = trace.find(key, pos + 1)) {
+    size_t begin = trace.find(fieldKey, pos) + fieldKey.size();
+    size_t end = trace.find_first_of(",}", begin);
+    values.push_back(trace.substr(begin, end - begin));
+  }
+  return values;
+}
+
+/// Returns the number of recorded spans named \p name.
+static unsigned countSpans(StringRef name) {
+  return getSpanFields(name, "name").size();
+}
+
+TEST(Tracing, RecordsOnlyWhenEnabled) {
+  disable();
+  { TracedSpan span("Tracing.Disabled", "test"); }
+  EXPECT_EQ(0u, countSpans("Tracing.Disabled"));
+
+  enable();
+  {
+    TracedSpan outer("Tracing.Outer", "test");
+    TracedSpan inner("Tracing.Inner \"quoted\"", "test");
+  }
+  disable();
+  EXPECT_EQ(1u, countSpans("Tracing.Outer"));
+  EXPECT_EQ(1u, countSpans("Tracing.Inner \\\"quoted\\\""));
+}
+
+TEST(Tracing, OverwritesOldestSpans) {
+  const unsigned NumSpans = 100000;
+  std::thread thread([] {
+    // Span I starts at I microseconds.
+    for (uint64_t i = 1; i <= NumSpans; ++i)
+      recordSpan("Tracing.Many", "test", i * 1000, i * 1000 + 1);
+  });
+  thread.join();
+
+  std::vector<std::string> startTimes = getSpanFields("Tracing.Many", "ts");
+  ASSERT_EQ(SpansPerThread, startTimes.size());
+  std::set<uint64_t> kept;
+  for (auto &startTime : startTimes)
+    kept.insert(std::stoull(startTime));
+  EXPECT_EQ(SpansPerThread, kept.size());
+  EXPECT_EQ(NumSpans - SpansPerThread + 1, *kept.begin());
+  EXPECT_EQ(NumSpans, *kept.rbegin());
+}
+
+TEST(Tracing, ReusesBuffersOfExitedThreads) {
+  for (unsigned i = 0; i != 100; ++i) {
+    std::thread thread([] {
+      recordSpan("Tracing.Reused", "test", 1000, 2000);
+    });
+    thread.join();
+  }
+
+  // Each thread takes the buffer the previous one left.
+  std::vector<std::string> threadIDs = getSpanFields("Tracing.Reused", "tid");
+  ASSERT_EQ(100u, threadIDs.size());
+  for (auto &threadID : threadIDs)
+    EXPECT_EQ(threadIDs.front(), threadID);
+}
+
+TEST(Tracing, WritesWhileRecording) {
+  enable();
+  std::thread thread([] {
+    for (unsigned i = 0; i != 100000; ++i)
+      TracedSpan span("Tracing.Concurrent", "test");
+  });
+  for (unsigned i = 0; i != 10; ++i)
+    (void)countSpans("Tracing.Concurrent");
+  thread.join();
+  disable();
+
+  EXPECT_LT(0u, countSpans("Tracing.Concurrent"));
+}
+} // end anonymous namespace
@@ -153,3 +153,78 @@ TEST(EnumTest, storeEnumTagSinglePayload) {
   ASSERT_TRUE(test_storeEnumTagSinglePayload({1, 1}, {219, 123},
                                               XI_TMBi8_, 3, 4));
 }
+
+TEST(EnumTest, storeAndGetEnumCaseSinglePayload) {
+  // 1 << 24 empty cases of Builtin.Int8 need four extra tag bytes.
+  const unsigned numEmptyCases = 1U << 24;
+  for (int whichCase : {-1, 0, 1, 255, 256, 65535, 65536, (1 << 24) - 1}) {
+    uint8_t buf[5] = {219, 123, 45, 67, 89};
+    swift_storeEnumTagSinglePayload(asOpaque(buf), &_TMBi8_.base,
+                                    whichCase, numEmptyCases);
+    ASSERT_EQ(whichCase,
+              swift_getEnumCaseSinglePayload(asOpaque(buf), &_TMBi8_.base,
+                                             numEmptyCases));
+  }
+}
+
+/// Metadata for a multi-payload enum whose payload cases all carry a
+/// Builtin.Int8, so the payload area is a single byte.
+struct MultiPayloadInt8Enum {
+  NominalTypeDescriptor Description;
+  ValueWitnessTable ValueWitnesses;
+  FullMetadata<EnumMetadata> Metadata;
+  size_t PayloadSize; // Must directly follow Metadata.
+
+  MultiPayloadInt8Enum(unsigned numPayloads, unsigned numEmptyCases) {
+    memset(&Description, 0, sizeof(Description));
+    memset(&Metadata, 0, sizeof(Metadata));
+
+    EnumMetadata *enumType = &Metadata;
+    size_t payloadSizeOffset =
+      (reinterpret_cast<size_t *>(&PayloadSize)
+         - reinterpret_cast<size_t *>(enumType));
+    Description.Kind = NominalTypeKind::Enum;
+    Description.Enum.NumPayloadCasesAndPayloadSizeOffset =
+      numPayloads | (payloadSizeOffset << 24);
+    Description.Enum.NumEmptyCases = numEmptyCases;
+
+    ValueWitnesses = _TWVBi8_;
+    Metadata.ValueWitnesses = &ValueWitnesses;
+    Metadata.setKind(MetadataKind::Enum);
+    Metadata.Description = &Description;
+
+    std::vector<const TypeLayout *> payloadLayouts(numPayloads,
+                                                   _TWVBi8_.getTypeLayout());
+    swift_initEnumMetadataMultiPayload(&ValueWitnesses, enumType, numPayloads,
+                                       payloadLayouts.data());
+  }
+};
+
+TEST(EnumTest, storeAndGetEnumCaseMultiPayload) {
+  // With a one-byte payload area, empty cases past the 256th spill into the
+  // tag byte, and only the low 8 bits of the empty case index go into the
+  // payload.
+  const unsigned numPayloads = 2, numEmptyCases = 1000;
+  MultiPayloadInt8Enum Enum(numPayloads, numEmptyCases);
+  ASSERT_EQ(1u, Enum.PayloadSize);
+  ASSERT_EQ(2u, Enum.ValueWitnesses.size);
+
+  for (unsigned whichCase : {0U, 1U, 2U, 3U, 7U, 2U + 255U, 2U + 256U,
+                             2U + 261U, 2U + 999U}) {
+    uint8_t buf[2] = {219, 123};
+    if (whichCase < numPayloads)
+      buf[0] = 45;
+    swift_storeEnumTagMultiPayload(asOpaque(buf), &Enum.Metadata, whichCase);
+    ASSERT_EQ(whichCase,
+              swift_getEnumCaseMultiPayload(asOpaque(buf), &Enum.Metadata));
+    // Payload cases leave their payload alone.
+    if (whichCase < numPayloads)
+      ASSERT_EQ(45, buf[0]);
+  }
+
+  // Empty case 261 is stored as payload 5 with tag 2 + 1.
+  uint8_t buf[2] = {219, 123};
+  swift_storeEnumTagMultiPayload(asOpaque(buf), &Enum.Metadata, 2 + 261);
+  ASSERT_EQ(5, buf[0]);
+  ASSERT_EQ(3, buf[1]);
+}
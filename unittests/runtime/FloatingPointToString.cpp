@@ -0,0 +1,171 @@
+//===- swift/unittests/runtime/FloatingPointToString.cpp ------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2015 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+extern "C" uint64_t swift_float32ToString(char *Buffer, size_t BufferLength,
+                                          float Value);
+extern "C" uint64_t swift_float64ToString(char *Buffer, size_t BufferLength,
+                                          double Value);
+
+static std::string toString(float Value) {
+  char Buffer[32];
+  return std::string(Buffer, swift_float32ToString(Buffer, 32, Value));
+}
+
+static std::string toString(double Value) {
+  char Buffer[32];
+  return std::string(Buffer, swift_float64ToString(Buffer, 32, Value));
+}
+
+static float parse(const char *Str, float) { return strtof(Str, nullptr); }
+static double parse(const char *Str, double) { return strtod(Str, nullptr); }
+
+/// The digits and scientific exponent of a decimal string, with leading and
+/// trailing zeros removed.
+struct DecimalDigits {
+  std::string Digits;
+  int Exponent;
+
+  DecimalDigits(const std::string &Str) {
+    size_t E = Str.find('e');
+    std::string Mantissa = Str.substr(0, E);
+    Exponent = E == std::string::npos ? 0 : atoi(Str.c_str() + E + 1);
+
+    size_t Dot = Mantissa.find('.');
+    size_t Start = Mantissa[0] == '-' ? 1 : 0;
+    if (Dot == std::string::npos)
+      Dot = Mantissa.size();
+    else
+      Mantissa.erase(Dot, 1);
+
+    size_t First = Mantissa.find_first_not_of('0', Start);
+    size_t Last = Mantissa.find_last_not_of('0');
+    Digits = Mantissa.substr(First, Last - First + 1);
+    Exponent += int(Dot) - int(First) - 1;
+  }
+
+  bool operator==(const DecimalDigits &Other) const {
+    return Digits == Other.Digits && Exponent == Other.Exponent;
+  }
+};
+
+/// Checks \p Value against the slow reference conversion: the fewest
+/// correctly rounded digits that read back as the same value.
+template <typename T>
+static ::testing::AssertionResult isShortestRoundTrip(T Value) {
+  std::string Str = toString(Value);
+  if (parse(Str.c_str(), T()) != Value)
+    return ::testing::AssertionFailure()
+           << Str << " does not read back as " << double(Value);
+
+  char Reference[64];
+  for (int Precision = 1; ; ++Precision) {
+    snprintf(Reference, sizeof(Reference), "%.*e", Precision - 1,
+             double(Value));
+    if (parse(Reference, T()) == Value)
+      break;
+  }
+  if (!(DecimalDigits(Str) == DecimalDigits(Reference)))
+    return ::testing::AssertionFailure()
+           << Str << " is not the shortest form " << Reference;
+  return ::testing::AssertionSuccess();
+}
+
+static void checkFloat32Range(uint32_t Stride) {
+  unsigned Failures = 0;
+  for (uint64_t Bits = 1; Bits < 0x7F800000; Bits += Stride) {
+    uint32_t Bits32 = uint32_t(Bits);
+    float Value;
+    memcpy(&Value, &Bits32, sizeof(Value));
+    ::testing::AssertionResult Result = isShortestRoundTrip(Value);
+    EXPECT_TRUE(Result);
+    if (!Result && ++Failures == 10)
+      return;
+  }
+}
+
+TEST(FloatingPointToString, Float32Special) {
+  EXPECT_EQ("0.0", toString(0.0f));
+  EXPECT_EQ("-0.0", toString(-0.0f));
+  EXPECT_EQ("inf", toString(INFINITY));
+  EXPECT_EQ("-inf", toString(-INFINITY));
+  EXPECT_EQ("nan", toString(NAN));
+  EXPECT_EQ("1e-45", toString(1e-45f));
+  EXPECT_EQ("3.4028235e+38", toString(3.4028235e38f));
+}
+
+TEST(FloatingPointToString, Float32Notation) {
+  EXPECT_EQ("1.0", toString(1.0f));
+  EXPECT_EQ("-100.125", toString(-100.125f));
+  EXPECT_EQ("0.1", toString(0.1f));
+  EXPECT_EQ("125000.0", toString(125000.0f));
+  EXPECT_EQ("1.25e+06", toString(1250000.0f));
+  EXPECT_EQ("1.6777216e+07", toString(16777216.0f));
+  EXPECT_EQ("0.000125", toString(0.000125f));
+  EXPECT_EQ("1.25e-05", toString(0.0000125f));
+}
+
+TEST(FloatingPointToString, Float64Special) {
+  EXPECT_EQ("0.0", toString(0.0));
+  EXPECT_EQ("-0.0", toString(-0.0));
+  EXPECT_EQ("inf", toString(double(INFINITY)));
+  EXPECT_EQ("-inf", toString(-double(INFINITY)));
+  EXPECT_EQ("nan", toString(double(NAN)));
+  EXPECT_EQ("5e-324", toString(5e-324));
+  EXPECT_EQ("1.7976931348623157e+308", toString(1.7976931348623157e308));
+}
+
+TEST(FloatingPointToString, Float64Notation) {
+  EXPECT_EQ("1.00000000000001", toString(1.00000000000001));
+  EXPECT_EQ("0.30000000000000004", toString(0.1 + 0.2));
+  EXPECT_EQ("125000000000000.0", toString(125000000000000.0));
+  EXPECT_EQ("1.25e+15", toString(1250000000000000.0));
+  EXPECT_EQ("1e+100", toString(1e100));
+  EXPECT_EQ("-2.5e-300", toString(-2.5e-300));
+}
+
+TEST(FloatingPointToString, Float32Sampled) {
+  // A prime stride visits every exponent and a spread of significands.
+  checkFloat32Range(10007);
+}
+
+TEST(FloatingPointToString, Float64Sampled) {
+  unsigned Failures = 0;
+  uint64_t Bits = 0x0123456789ABCDEF;
+  for (unsigned i = 0; i != 20000; ++i) {
+    // A 64-bit LCG covers all exponents, including subnormals.
+    Bits = Bits * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t Masked = Bits & 0x7FFFFFFFFFFFFFFFULL;
+    double Value;
+    memcpy(&Value, &Masked, sizeof(Value));
+    if (!std::isfinite(Value) || Value == 0)
+      continue;
+    ::testing::AssertionResult Result = isShortestRoundTrip(Value);
+    EXPECT_TRUE(Result);
+    if (!Result && ++Failures == 10)
+      return;
+  }
+}
+
+// Checks every positive finite Float; this takes hours, so it only runs with
+// --gtest_also_run_disabled_tests.
+TEST(FloatingPointToString, DISABLED_Float32Exhaustive) {
+  checkFloat32Range(1);
+}
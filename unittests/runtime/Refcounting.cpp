@@ -13,6 +13,8 @@
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
 #include "gtest/gtest.h"
+#include <thread>
+#include <vector>
 
 using namespace swift;
 
@@ -156,3 +158,69 @@ TEST(RefcountingTest, unowned_retain_release_n) {
   swift_release(object);
   EXPECT_EQ(1u, value);
 }
+
+TEST(RefcountingTest, weak_load_after_release) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref;
+  swift_weakInit(&ref, object);
+  auto loaded = swift_weakLoadStrong(&ref);
+  EXPECT_EQ(object, loaded);
+  swift_release(loaded);
+  EXPECT_EQ(0u, value);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  WeakReference copy;
+  swift_weakCopyInit(&copy, &ref);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&copy));
+  swift_weakDestroy(&copy);
+  swift_weakDestroy(&ref);
+}
+
+TEST(RefcountingTest, weak_load_concurrent) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref;
+  swift_weakInit(&ref, object);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i != 4; ++i) {
+    threads.emplace_back([&] {
+      for (unsigned j = 0; j != 10000; ++j) {
+        auto loaded = swift_weakLoadStrong(&ref);
+        EXPECT_EQ(object, loaded);
+        swift_release(loaded);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  EXPECT_EQ(1u, swift_retainCount(object));
+  EXPECT_EQ(0u, value);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  swift_weakDestroy(&ref);
+}
+
+TEST(RefcountingTest, immortal) {
+  static HeapObject object(&TestClassObjectMetadata, HeapObject::Immortal);
+  auto retainCount = swift_retainCount(&object);
+  auto unownedCount = swift_unownedRetainCount(&object);
+  swift_retain(&object);
+  swift_retain_n(&object, 8);
+  EXPECT_EQ(retainCount, swift_retainCount(&object));
+  swift_release_n(&object, 8);
+  swift_release(&object);
+  swift_release(&object);
+  EXPECT_EQ(retainCount, swift_retainCount(&object));
+  EXPECT_EQ(&object, swift_tryRetain(&object));
+  EXPECT_EQ(nullptr, swift_tryPin(&object));
+  swift_unownedRetain(&object);
+  swift_unownedRelease(&object);
+  swift_unownedRelease(&object);
+  EXPECT_EQ(unownedCount, swift_unownedRetainCount(&object));
+  swift_unownedRetainStrong(&object);
+  EXPECT_FALSE(swift_isDeallocating(&object));
+}
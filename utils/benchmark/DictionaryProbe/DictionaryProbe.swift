@@ -0,0 +1,74 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Looks up keys that are present and keys that are not in a Dictionary of
+// String keys, then churns a Set of Ints by inserting and removing elements
+// so that probe sequences keep changing.
+
+func makeKeys(count: Int, prefix: String) -> [String] {
+  var keys = [String]()
+  for i in 0..<count {
+    keys.append("\(prefix)-\(i * 7919)")
+  }
+  return keys
+}
+
+@inline(never)
+func countHits(dict: [String : Int], _ keys: [String]) -> Int {
+  var hits = 0
+  for key in keys {
+    if let value = dict[key] {
+      hits = hits &+ value
+    }
+  }
+  return hits
+}
+
+@inline(never)
+func churn(inout set: Set<Int>, _ round: Int) {
+  for i in 0..<1000 {
+    set.insert(round &* 1000 &+ i)
+  }
+  for i in 0..<1000 {
+    set.remove((round &- 1) &* 1000 &+ i)
+  }
+}
+
+func benchDictionaryProbe() {
+  let present = makeKeys(10_000, prefix: "key")
+  let absent = makeKeys(10_000, prefix: "missing")
+  var dict = [String : Int]()
+  for (i, key) in present.enumerate() {
+    dict[key] = i
+  }
+  let iterations = 100
+
+  var start = __mach_absolute_time__()
+  var hits = 0
+  for _ in 0..<iterations {
+    hits = hits &+ countHits(dict, present)
+  }
+  var delta = __mach_absolute_time__() - start
+  print("hit: \(delta) nanoseconds. \(hits)")
+  let lookupCount = Double(iterations * present.count)
+  print("hit: \(Double(delta) / lookupCount) nanoseconds/lookup")
+
+  start = __mach_absolute_time__()
+  hits = 0
+  for _ in 0..<iterations {
+    hits = hits &+ countHits(dict, absent)
+  }
+  delta = __mach_absolute_time__() - start
+  print("miss: \(delta) nanoseconds. \(hits)")
+  print("miss: \(Double(delta) / lookupCount) nanoseconds/lookup")
+
+  var set = Set<Int>()
+  start = __mach_absolute_time__()
+  for round in 0..<1000 {
+    churn(&set, round)
+  }
+  delta = __mach_absolute_time__() - start
+  print("churn: \(delta) nanoseconds. \(set.count)")
+  print("churn: \(Double(delta) / 2_000_000) nanoseconds/operation")
+}
+
+benchDictionaryProbe()
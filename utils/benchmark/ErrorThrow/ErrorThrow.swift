@@ -0,0 +1,91 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// A digit parser that reports malformed input by throwing, and a caller that
+// catches and counts the failures. Half the inputs are malformed, so the
+// throw/catch path is as hot as the success path.
+
+enum ParseError : ErrorType {
+  case Empty
+  case BadDigit
+  case Overflow
+}
+
+struct ParseFailure : ErrorType {
+  let offset: Int
+  let reason: String
+}
+
+@inline(never)
+func parseDigits(input: [UInt8]) throws -> Int {
+  if input.isEmpty { throw ParseError.Empty }
+  var result = 0
+  for c in input {
+    if c < 48 || c > 57 { throw ParseError.BadDigit }
+    if result > 100_000_000 { throw ParseError.Overflow }
+    result = result * 10 + Int(c - 48)
+  }
+  return result
+}
+
+// The same parser with an error struct, which always needs a heap box.
+@inline(never)
+func parseDigitsWithPayload(input: [UInt8]) throws -> Int {
+  var result = 0
+  for (i, c) in input.enumerate() {
+    if c < 48 || c > 57 { throw ParseFailure(offset: i, reason: "bad digit") }
+    result = result * 10 + Int(c - 48)
+  }
+  return result
+}
+
+func makeInputs() -> [[UInt8]] {
+  var inputs = [[UInt8]]()
+  for i in 0..<1000 {
+    switch i % 4 {
+    case 0: inputs.append(Array("12345".utf8))
+    case 1: inputs.append(Array("12x45".utf8))
+    case 2: inputs.append([])
+    default: inputs.append(Array("987".utf8))
+    }
+  }
+  return inputs
+}
+
+func benchErrorThrow() {
+  let inputs = makeInputs()
+  let iterations = 1_000
+
+  var start = __mach_absolute_time__()
+  var failures = 0
+  var sum = 0
+  for _ in 0..<iterations {
+    for input in inputs {
+      do {
+        sum = sum &+ (try parseDigits(input))
+      } catch {
+        failures += 1
+      }
+    }
+  }
+  var delta = __mach_absolute_time__() - start
+  print("enum: \(delta) nanoseconds. \(sum) \(failures)")
+  print("enum: \(Double(delta) / Double(failures)) nanoseconds/throw")
+
+  start = __mach_absolute_time__()
+  failures = 0
+  sum = 0
+  for _ in 0..<iterations {
+    for input in inputs {
+      do {
+        sum = sum &+ (try parseDigitsWithPayload(input))
+      } catch {
+        failures += 1
+      }
+    }
+  }
+  delta = __mach_absolute_time__() - start
+  print("struct: \(delta) nanoseconds. \(sum) \(failures)")
+  print("struct: \(Double(delta) / Double(failures)) nanoseconds/throw")
+}
+
+benchErrorThrow()
@@ -0,0 +1,56 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Formats arrays of Floats and Doubles the way a JSON encoder would: many
+// short descriptions, some exact and some needing every significant digit.
+
+func makeDoubles() -> [Double] {
+  var values = [Double]()
+  var x = 0.1
+  for i in 0..<1000 {
+    switch i % 4 {
+    case 0: values.append(Double(i))
+    case 1: values.append(Double(i) / 8)
+    case 2: values.append(x)
+    default: values.append(1.0 / Double(i))
+    }
+    x = x * 1.37 + 0.01
+  }
+  return values
+}
+
+@inline(never)
+func formatAll<T : CustomStringConvertible>(values: [T]) -> Int {
+  var length = 0
+  for value in values {
+    length += value.description.utf8.count
+  }
+  return length
+}
+
+func benchFloatToString() {
+  let doubles = makeDoubles()
+  let floats = doubles.map { Float($0) }
+  let iterations = 1_000
+
+  var start = __mach_absolute_time__()
+  var length = 0
+  for _ in 0..<iterations {
+    length += formatAll(doubles)
+  }
+  var delta = __mach_absolute_time__() - start
+  print("Double: \(delta) nanoseconds. \(length)")
+  let doubleCount = Double(iterations * doubles.count)
+  print("Double: \(Double(delta) / doubleCount) nanoseconds/value")
+
+  start = __mach_absolute_time__()
+  length = 0
+  for _ in 0..<iterations {
+    length += formatAll(floats)
+  }
+  delta = __mach_absolute_time__() - start
+  print("Float: \(delta) nanoseconds. \(length)")
+  let floatCount = Double(iterations * floats.count)
+  print("Float: \(Double(delta) / floatCount) nanoseconds/value")
+}
+
+benchFloatToString()
@@ -0,0 +1,72 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Wraps and unwraps values in Optional and in a two-payload enum from generic
+// code that is not specialized, so that every case test, projection and
+// injection goes through the runtime's enum value witnesses.
+
+enum Either<Left, Right> {
+  case left(Left)
+  case right(Right)
+  case neither
+}
+
+@_semantics("optimize.sil.never")
+func sumOptionals<T>(values: [T?], _ transform: T -> Int) -> Int {
+  var sum = 0
+  for value in values {
+    if let value = value {
+      sum = sum &+ transform(value)
+    }
+  }
+  return sum
+}
+
+@_semantics("optimize.sil.never")
+func wrap<T>(value: T, _ index: Int) -> Either<T, T> {
+  switch index % 3 {
+  case 0: return .left(value)
+  case 1: return .right(value)
+  default: return .neither
+  }
+}
+
+@_semantics("optimize.sil.never")
+func countLefts<T>(values: [T]) -> Int {
+  var count = 0
+  for (i, value) in values.enumerate() {
+    if case .left = wrap(value, i) {
+      count += 1
+    }
+  }
+  return count
+}
+
+func benchGenericEnum() {
+  var optionals = [Int?]()
+  for i in 0..<10_000 {
+    optionals.append(i % 4 == 0 ? nil : i)
+  }
+  let values = [Int](0..<10_000)
+  let iterations = 100
+
+  var start = __mach_absolute_time__()
+  var sum = 0
+  for _ in 0..<iterations {
+    sum = sum &+ sumOptionals(optionals) { $0 }
+  }
+  var delta = __mach_absolute_time__() - start
+  print("optional: \(delta) nanoseconds. \(sum)")
+  let valueCount = Double(iterations * values.count)
+  print("optional: \(Double(delta) / valueCount) nanoseconds/value")
+
+  start = __mach_absolute_time__()
+  var count = 0
+  for _ in 0..<iterations {
+    count = count &+ countLefts(values)
+  }
+  delta = __mach_absolute_time__() - start
+  print("multi-payload: \(delta) nanoseconds. \(count)")
+  print("multi-payload: \(Double(delta) / valueCount) nanoseconds/value")
+}
+
+benchGenericEnum()
@@ -0,0 +1,158 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// A small stack machine, in the style of a bytecode interpreter's inner
+// loop.  The opcode dispatch is written both as a 'switch' over an enum and
+// as an if/else-if ladder over raw integer opcodes; after inlining, both
+// should become a single switch rather than a chain of comparisons.
+
+enum Op {
+  case Push(Int)
+  case Pop
+  case Dup
+  case Swap
+  case Add
+  case Sub
+  case Mul
+  case And
+  case Or
+  case Xor
+  case Shl
+  case Shr
+  case Inc
+  case Dec
+  case Neg
+  case Nop
+}
+
+func runEnum(program: [Op], iterations: Int) -> Int {
+  var stack = [Int](count: 64, repeatedValue: 0)
+  var sp = 0
+  var checksum = 0
+  for _ in 0..<iterations {
+    sp = 0
+    for op in program {
+      switch op {
+      case .Push(let v): stack[sp] = v; sp += 1
+      case .Pop: sp -= 1
+      case .Dup: stack[sp] = stack[sp - 1]; sp += 1
+      case .Swap:
+        let t = stack[sp - 1]; stack[sp - 1] = stack[sp - 2]; stack[sp - 2] = t
+      case .Add: stack[sp - 2] = stack[sp - 2] &+ stack[sp - 1]; sp -= 1
+      case .Sub: stack[sp - 2] = stack[sp - 2] &- stack[sp - 1]; sp -= 1
+      case .Mul: stack[sp - 2] = stack[sp - 2] &* stack[sp - 1]; sp -= 1
+      case .And: stack[sp - 2] = stack[sp - 2] & stack[sp - 1]; sp -= 1
+      case .Or: stack[sp - 2] = stack[sp - 2] | stack[sp - 1]; sp -= 1
+      case .Xor: stack[sp - 2] = stack[sp - 2] ^ stack[sp - 1]; sp -= 1
+      case .Shl: stack[sp - 1] = stack[sp - 1] << 1
+      case .Shr: stack[sp - 1] = stack[sp - 1] >> 1
+      case .Inc: stack[sp - 1] = stack[sp - 1] &+ 1
+      case .Dec: stack[sp - 1] = stack[sp - 1] &- 1
+      case .Neg: stack[sp - 1] = 0 &- stack[sp - 1]
+      case .Nop: break
+      }
+    }
+    checksum = checksum &+ stack[0]
+  }
+  return checksum
+}
+
+// The same machine with opcodes as raw bytes, dispatched by comparisons.
+func runBytes(program: [UInt8], iterations: Int) -> Int {
+  var stack = [Int](count: 64, repeatedValue: 0)
+  var sp = 0
+  var checksum = 0
+  for _ in 0..<iterations {
+    sp = 0
+    var pc = 0
+    while pc < program.count {
+      let op = program[pc]
+      pc += 1
+      if op == 0 {
+        stack[sp] = Int(program[pc]); pc += 1; sp += 1
+      } else if op == 1 {
+        sp -= 1
+      } else if op == 2 {
+        stack[sp] = stack[sp - 1]; sp += 1
+      } else if op == 3 {
+        let t = stack[sp - 1]; stack[sp - 1] = stack[sp - 2]; stack[sp - 2] = t
+      } else if op == 4 {
+        stack[sp - 2] = stack[sp - 2] &+ stack[sp - 1]; sp -= 1
+      } else if op == 5 {
+        stack[sp - 2] = stack[sp - 2] &- stack[sp - 1]; sp -= 1
+      } else if op == 6 {
+        stack[sp - 2] = stack[sp - 2] &* stack[sp - 1]; sp -= 1
+      } else if op == 7 {
+        stack[sp - 2] = stack[sp - 2] & stack[sp - 1]; sp -= 1
+      } else if op == 8 {
+        stack[sp - 2] = stack[sp - 2] | stack[sp - 1]; sp -= 1
+      } else if op == 9 {
+        stack[sp - 2] = stack[sp - 2] ^ stack[sp - 1]; sp -= 1
+      } else if op == 10 {
+        stack[sp - 1] = stack[sp - 1] << 1
+      } else if op == 11 {
+        stack[sp - 1] = stack[sp - 1] >> 1
+      } else if op >= 12 && op <= 13 {
+        stack[sp - 1] = stack[sp - 1] &+ (op == 12 ? 1 : -1)
+      } else if op == 14 {
+        stack[sp - 1] = 0 &- stack[sp - 1]
+      }
+    }
+    checksum = checksum &+ stack[0]
+  }
+  return checksum
+}
+
+// A pseudo-random program that keeps the stack depth between 1 and 32.
+func makeProgram(length: Int) -> ([Op], [UInt8]) {
+  var ops = [Op]()
+  var bytes = [UInt8]()
+  var seed: UInt32 = 42
+  var depth = 0
+  ops.append(.Push(1)); bytes += [0, 1]; depth = 1
+  while ops.count < length {
+    seed = seed &* 1103515245 &+ 12345
+    var code = UInt8(truncatingBitPattern: seed >> 16) % 16
+    if depth < 2 && (code == 1 || (code >= 3 && code <= 9)) { code = 0 }
+    if depth > 30 && (code == 0 || code == 2) { code = 4 }
+    switch code {
+    case 0: ops.append(.Push(Int(seed % 7))); bytes += [0, UInt8(seed % 7)]
+      depth += 1
+    case 1: ops.append(.Pop); bytes.append(1); depth -= 1
+    case 2: ops.append(.Dup); bytes.append(2); depth += 1
+    case 3: ops.append(.Swap); bytes.append(3)
+    case 4: ops.append(.Add); bytes.append(4); depth -= 1
+    case 5: ops.append(.Sub); bytes.append(5); depth -= 1
+    case 6: ops.append(.Mul); bytes.append(6); depth -= 1
+    case 7: ops.append(.And); bytes.append(7); depth -= 1
+    case 8: ops.append(.Or); bytes.append(8); depth -= 1
+    case 9: ops.append(.Xor); bytes.append(9); depth -= 1
+    case 10: ops.append(.Shl); bytes.append(10)
+    case 11: ops.append(.Shr); bytes.append(11)
+    case 12: ops.append(.Inc); bytes.append(12)
+    case 13: ops.append(.Dec); bytes.append(13)
+    case 14: ops.append(.Neg); bytes.append(14)
+    default: ops.append(.Nop); bytes.append(15)
+    }
+  }
+  return (ops, bytes)
+}
+
+func benchInterpreterDispatch() {
+  let (ops, bytes) = makeProgram(1000)
+  let iterations = 10_000
+  let instructions = Double(iterations * ops.count)
+
+  var start = __mach_absolute_time__()
+  var checksum = runEnum(ops, iterations: iterations)
+  var delta = __mach_absolute_time__() - start
+  print("enum: \(delta) nanoseconds. \(checksum)")
+  print("enum: \(Double(delta) / instructions) nanoseconds/instruction")
+
+  start = __mach_absolute_time__()
+  checksum = runBytes(bytes, iterations: iterations)
+  delta = __mach_absolute_time__() - start
+  print("bytes: \(delta) nanoseconds. \(checksum)")
+  print("bytes: \(Double(delta) / instructions) nanoseconds/instruction")
+}
+
+benchInterpreterDispatch()
@@ -0,0 +1,66 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Parses the fields of CSV-style numeric rows: an integer id, a price with
+// two decimals, a quantity, and a measurement with more digits.
+
+func makeFields() -> (ints: [String], doubles: [String]) {
+  var ints = [String]()
+  var doubles = [String]()
+  var seed = 12345
+  for i in 0..<10_000 {
+    seed = (seed &* 1103515245 &+ 12345) & 0x7FFF_FFFF
+    let line = "\(i),\(seed % 100000 / 100).\(seed % 100),\(seed % 500)," +
+      "\(Double(seed) / 1024.0)"
+    let fields = line.characters.split(",").map(String.init)
+    ints.append(fields[0])
+    doubles.append(fields[1])
+    ints.append(fields[2])
+    doubles.append(fields[3])
+  }
+  return (ints, doubles)
+}
+
+@inline(never)
+func parseInts(fields: [String]) -> Int {
+  var sum = 0
+  for field in fields {
+    sum = sum &+ Int(field)!
+  }
+  return sum
+}
+
+@inline(never)
+func parseDoubles(fields: [String]) -> Double {
+  var sum = 0.0
+  for field in fields {
+    sum += Double(field)!
+  }
+  return sum
+}
+
+func benchParseCSV() {
+  let (ints, doubles) = makeFields()
+  let iterations = 100
+
+  var start = __mach_absolute_time__()
+  var intSum = 0
+  for _ in 0..<iterations {
+    intSum = intSum &+ parseInts(ints)
+  }
+  var delta = __mach_absolute_time__() - start
+  print("Int: \(delta) nanoseconds. \(intSum)")
+  let intCount = Double(iterations * ints.count)
+  print("Int: \(Double(delta) / intCount) nanoseconds/field")
+
+  start = __mach_absolute_time__()
+  var doubleSum = 0.0
+  for _ in 0..<iterations {
+    doubleSum += parseDoubles(doubles)
+  }
+  delta = __mach_absolute_time__() - start
+  print("Double: \(delta) nanoseconds. \(doubleSum)")
+  let doubleCount = Double(iterations * doubles.count)
+  print("Double: \(Double(delta) / doubleCount) nanoseconds/field")
+}
+
+benchParseCSV()
@@ -0,0 +1,39 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+@_silgen_name("_swift_stdlib_putc_stderr") func __putc_stderr__(c: Int32) -> Int32
+
+// Prints ten million short log lines, as a log-heavy command-line tool would.
+// Run with standard output redirected, e.g. to /dev/null; the timings are
+// written to standard error.
+
+struct StderrStream : OutputStreamType {
+  mutating func write(string: String) {
+    for c in string.utf8 {
+      __putc_stderr__(Int32(c))
+    }
+  }
+}
+
+func benchPrintLines() {
+  let lines = 10_000_000
+  var stderr = StderrStream()
+
+  var start = __mach_absolute_time__()
+  for i in 0..<lines {
+    print("INFO request", i, "completed")
+  }
+  var delta = __mach_absolute_time__() - start
+  print("ascii: \(delta) nanoseconds.", toStream: &stderr)
+  print("ascii: \(Double(delta) / Double(lines)) nanoseconds/line",
+        toStream: &stderr)
+
+  start = __mach_absolute_time__()
+  for i in 0..<lines {
+    print("INFO requête", i, "terminée")
+  }
+  delta = __mach_absolute_time__() - start
+  print("non-ascii: \(delta) nanoseconds.", toStream: &stderr)
+  print("non-ascii: \(Double(delta) / Double(lines)) nanoseconds/line",
+        toStream: &stderr)
+}
+
+benchPrintLines()
@@ -0,0 +1,41 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Builds logging-style messages with several interpolated values.  Run with
+// SWIFT_HEAP_PROFILE=<file> SWIFT_HEAP_PROFILE_RATE=1 and read the
+// alloc_objects column of the profile to count allocations per message.
+
+struct Request {
+  var method: String
+  var path: String
+  var status: Int
+  var bytes: Int
+  var elapsed: Double
+}
+
+@inline(never)
+func formatLine(request: Request, _ sequence: Int) -> String {
+  return "[\(sequence)] \(request.method) \(request.path) -> \(request.status) (\(request.bytes) bytes in \(request.elapsed) ms)"
+}
+
+func benchStringInterpolation() {
+  let requests = [
+    Request(method: "GET", path: "/index.html", status: 200, bytes: 5120,
+            elapsed: 1.5),
+    Request(method: "POST", path: "/api/v1/upload", status: 201,
+            bytes: 1048576, elapsed: 87.25),
+    Request(method: "GET", path: "/missing", status: 404, bytes: 0,
+            elapsed: 0.5),
+  ]
+  let lineCount = 300_000
+
+  let start = __mach_absolute_time__()
+  var length = 0
+  for i in 0..<lineCount {
+    length = length &+ formatLine(requests[i % requests.count], i).utf16.count
+  }
+  let delta = __mach_absolute_time__() - start
+  print("\(delta) nanoseconds. \(length)")
+  print("\(Double(delta) / Double(lineCount)) nanoseconds/line")
+}
+
+benchStringInterpolation()
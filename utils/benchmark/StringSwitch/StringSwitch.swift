@@ -0,0 +1,164 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Dispatch over 109 keywords, in the style of a hand-written protocol or
+// language tokenizer.  Each case returns its position in the list.
+func keywordIndex(s: String) -> Int {
+  switch s {
+  case "associatedtype": return 0
+  case "class": return 1
+  case "deinit": return 2
+  case "enum": return 3
+  case "extension": return 4
+  case "func": return 5
+  case "import": return 6
+  case "init": return 7
+  case "inout": return 8
+  case "internal": return 9
+  case "let": return 10
+  case "operator": return 11
+  case "private": return 12
+  case "protocol": return 13
+  case "public": return 14
+  case "static": return 15
+  case "struct": return 16
+  case "subscript": return 17
+  case "typealias": return 18
+  case "var": return 19
+  case "break": return 20
+  case "case": return 21
+  case "continue": return 22
+  case "default": return 23
+  case "defer": return 24
+  case "do": return 25
+  case "else": return 26
+  case "fallthrough": return 27
+  case "for": return 28
+  case "guard": return 29
+  case "if": return 30
+  case "in": return 31
+  case "repeat": return 32
+  case "return": return 33
+  case "switch": return 34
+  case "where": return 35
+  case "while": return 36
+  case "as": return 37
+  case "catch": return 38
+  case "dynamicType": return 39
+  case "false": return 40
+  case "is": return 41
+  case "nil": return 42
+  case "rethrows": return 43
+  case "super": return 44
+  case "self": return 45
+  case "Self": return 46
+  case "throw": return 47
+  case "throws": return 48
+  case "true": return 49
+  case "try": return 50
+  case "__COLUMN__": return 51
+  case "__FILE__": return 52
+  case "__FUNCTION__": return 53
+  case "__LINE__": return 54
+  case "associativity": return 55
+  case "convenience": return 56
+  case "dynamic": return 57
+  case "didSet": return 58
+  case "final": return 59
+  case "get": return 60
+  case "infix": return 61
+  case "indirect": return 62
+  case "lazy": return 63
+  case "left": return 64
+  case "mutating": return 65
+  case "none": return 66
+  case "nonmutating": return 67
+  case "optional": return 68
+  case "override": return 69
+  case "postfix": return 70
+  case "precedence": return 71
+  case "prefix": return 72
+  case "Protocol": return 73
+  case "required": return 74
+  case "right": return 75
+  case "set": return 76
+  case "Type": return 77
+  case "unowned": return 78
+  case "weak": return 79
+  case "willSet": return 80
+  case "put": return 81
+  case "post": return 82
+  case "delete": return 83
+  case "head": return 84
+  case "options": return 85
+  case "patch": return 86
+  case "connect": return 87
+  case "trace": return 88
+  case "accept": return 89
+  case "charset": return 90
+  case "encoding": return 91
+  case "language": return 92
+  case "range": return 93
+  case "authorization": return 94
+  case "cache": return 95
+  case "control": return 96
+  case "connection": return 97
+  case "cookie": return 98
+  case "date": return 99
+  case "expect": return 100
+  case "from": return 101
+  case "host": return 102
+  case "origin": return 103
+  case "pragma": return 104
+  case "referer": return 105
+  case "upgrade": return 106
+  case "via": return 107
+  case "warning": return 108
+  default: return -1
+  }
+}
+
+let keywords = [
+  "associatedtype", "class", "deinit", "enum", "extension", "func", "import",
+  "init", "inout", "internal", "let", "operator", "private", "protocol",
+  "public", "static", "struct", "subscript", "typealias", "var", "break",
+  "case", "continue", "default", "defer", "do", "else", "fallthrough", "for",
+  "guard", "if", "in", "repeat", "return", "switch", "where", "while", "as",
+  "catch", "dynamicType", "false", "is", "nil", "rethrows", "super", "self",
+  "Self", "throw", "throws", "true", "try", "__COLUMN__", "__FILE__",
+  "__FUNCTION__", "__LINE__", "associativity", "convenience", "dynamic",
+  "didSet", "final", "get", "infix", "indirect", "lazy", "left", "mutating",
+  "none", "nonmutating", "optional", "override", "postfix", "precedence",
+  "prefix", "Protocol", "required", "right", "set", "Type", "unowned", "weak",
+  "willSet", "put", "post", "delete", "head", "options", "patch", "connect",
+  "trace", "accept", "charset", "encoding", "language", "range",
+  "authorization", "cache", "control", "connection", "cookie", "date",
+  "expect", "from", "host", "origin", "pragma", "referer", "upgrade", "via",
+  "warning"
+]
+
+// Identifiers that are not keywords, to measure the cost of a miss.
+let identifiers = keywords.map { $0 + "_" }
+
+func benchStringSwitch(inputs: [String], iterations: Int) -> Int {
+  var checksum = 0
+  for _ in 0..<iterations {
+    for s in inputs {
+      checksum = checksum &+ keywordIndex(s)
+    }
+  }
+  return checksum
+}
+
+func benchStringSwitch() {
+  for (name, inputs) in [("hit", keywords), ("miss", identifiers)] {
+    let iterations = 10_000
+    let start = __mach_absolute_time__()
+    let checksum = benchStringSwitch(inputs, iterations: iterations)
+    let delta = __mach_absolute_time__() - start
+    let lookups = Double(iterations * inputs.count)
+    print("\(name): \(delta) nanoseconds. \(checksum)")
+    print("\(name): \(Double(delta) / lookups) nanoseconds/lookup")
+  }
+}
+
+benchStringSwitch()
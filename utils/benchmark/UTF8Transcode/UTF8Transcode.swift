@@ -0,0 +1,48 @@
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Round-trips log lines between C strings and Strings, the way a program
+// reading and writing text through the C library would. One corpus is all
+// ASCII; the other mixes in Cyrillic and emoji.
+
+func makeLine(i: Int, ascii: Bool) -> String {
+  if ascii {
+    return "\(i): GET /index.html HTTP/1.1 200 OK, served in \(i % 97) ms"
+  }
+  return "\(i): получено сообщение 😀 от пользователя, \(i % 97) мс"
+}
+
+func makeCorpus(ascii ascii: Bool) -> [ContiguousArray<UInt8>] {
+  var lines = [ContiguousArray<UInt8>]()
+  for i in 0..<1000 {
+    lines.append(makeLine(i, ascii: ascii).nulTerminatedUTF8)
+  }
+  return lines
+}
+
+@inline(never)
+func roundTrip(lines: [ContiguousArray<UInt8>]) -> Int {
+  var bytes = 0
+  for line in lines {
+    let s = line.withUnsafeBufferPointer {
+      String.fromCString(UnsafePointer($0.baseAddress))!
+    }
+    bytes += s.nulTerminatedUTF8.count
+  }
+  return bytes
+}
+
+func benchUTF8Transcode(name: String, lines: [ContiguousArray<UInt8>]) {
+  let iterations = 1_000
+
+  let start = __mach_absolute_time__()
+  var bytes = 0
+  for _ in 0..<iterations {
+    bytes += roundTrip(lines)
+  }
+  let delta = __mach_absolute_time__() - start
+  print("\(name): \(delta) nanoseconds. \(bytes)")
+  print("\(name): \(Double(bytes) * 1000 / Double(delta)) MB/s")
+}
+
+benchUTF8Transcode("ASCII", lines: makeCorpus(ascii: true))
+benchUTF8Transcode("Non-ASCII", lines: makeCorpus(ascii: false))
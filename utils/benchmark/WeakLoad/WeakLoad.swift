@@ -0,0 +1,61 @@
+import Darwin
+
+@_silgen_name("mach_absolute_time") func __mach_absolute_time__() -> UInt64
+
+// Loads the same weak reference from several threads at once, as happens with
+// delegates and caches shared between queues.  Reports the time per load for
+// each thread count; it should stay flat as threads are added.
+
+final class Target {
+  var value = 1
+}
+
+final class Holder {
+  weak var target: Target?
+  init(_ target: Target) { self.target = target }
+}
+
+let loadsPerThread = 1_000_000
+
+@inline(never)
+func loadRepeatedly(holder: Holder) -> Int {
+  var sum = 0
+  for _ in 0..<loadsPerThread {
+    if let target = holder.target {
+      sum = sum &+ target.value
+    }
+  }
+  return sum
+}
+
+func runThreads(holder: Holder, _ threadCount: Int) -> UInt64 {
+  let context = UnsafeMutablePointer<Void>(Unmanaged.passUnretained(holder).toOpaque())
+  var threads = [pthread_t](count: threadCount, repeatedValue: nil)
+  let start = __mach_absolute_time__()
+  for i in 0..<threadCount {
+    pthread_create(&threads[i], nil, { context in
+      let holder = Unmanaged<Holder>.fromOpaque(COpaquePointer(context))
+        .takeUnretainedValue()
+      loadRepeatedly(holder)
+      return nil
+    }, context)
+  }
+  for thread in threads {
+    pthread_join(thread, nil)
+  }
+  return __mach_absolute_time__() - start
+}
+
+func benchWeakLoad() {
+  let target = Target()
+  let holder = Holder(target)
+  for threadCount in [1, 2, 4, 8] {
+    let delta = runThreads(holder, threadCount)
+    print("\(threadCount) threads: \(delta) nanoseconds.")
+    let loadCount = Double(threadCount * loadsPerThread)
+    print("\(threadCount) threads: \(Double(delta) / loadCount) nanoseconds/load")
+  }
+  withExtendedLifetime(target) {}
+}
+
+benchWeakLoad()